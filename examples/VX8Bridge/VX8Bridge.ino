@@ -0,0 +1,33 @@
+// GPS-to-VX-8R bridge. Runs on any supported board (see board.h):
+//
+//   ATmega328P (Uno, Nano, Pro Mini): GPS TX -> D0 (RX), D1 (TX) -> VX-8R
+//     GPS data in. Disconnect the GPS from D0 while uploading.
+//   SAMD21 (Zero, Feather M0): GPS on D0/D1, D10 -> VX-8R.
+//   RP2040: GPS on GP1 (RX) / GP0 (TX), GP4 -> VX-8R.
+//   ESP32: GPS on GPIO16 (RX) / GPIO17 (TX), GPIO4 -> VX-8R.
+//
+// Common ground throughout. Pulling D2 to ground (or sending $PVX8Q on the
+// GPS line) sends a $PVX8S diagnostics report to the radio side. Built with
+// VX8_PPS_SYNC, the module's PPS output goes to VX8_PPS_PIN (D3 on AVR).
+// Built with VX8_FIX_LOG, an SPI flash chip (or SD card) on the SPI pins
+// with chip select on VX8_LOG_CS_PIN (D10 on AVR) keeps a track log; send
+// $PVX8L or $PVX8L,GPX to read it back.
+
+#include <firmware.h>
+
+static const uint8_t kReportPin = 2;
+
+static vx8::Firmware firmware;
+
+void setup() {
+  pinMode(kReportPin, INPUT_PULLUP);
+  firmware.setup();
+}
+
+void loop() {
+  static bool reportPinWasLow = false;
+  const bool reportPinLow = digitalRead(kReportPin) == LOW;
+  if (reportPinLow && !reportPinWasLow) firmware.monitor().requestReport();
+  reportPinWasLow = reportPinLow;
+  firmware.loop();
+}
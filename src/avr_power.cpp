@@ -0,0 +1,90 @@
+#if defined(__AVR__)
+
+#include "avr_power.h"
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#include "avr_uart.h"
+
+// RXD0 is PD0 (PCINT16) on the 328P and PE0 (PCINT8) on the 2560.
+#if defined(__AVR_ATmega2560__)
+#define VX8_RXD_PCMSK PCMSK1
+#define VX8_RXD_PCINT PCINT8
+#define VX8_RXD_PCIE PCIE1
+#define VX8_RXD_VECT PCINT1_vect
+#else
+#define VX8_RXD_PCMSK PCMSK2
+#define VX8_RXD_PCINT PCINT16
+#define VX8_RXD_PCIE PCIE2
+#define VX8_RXD_VECT PCINT2_vect
+#endif
+
+namespace vx8 {
+namespace avr {
+
+namespace {
+
+const uint8_t kSliceMs = 16;
+
+volatile uint32_t g_sleptMs = 0;
+volatile bool g_rxWake = false;
+
+void powerDown(uint16_t ms) {
+  // Let the last byte out; the USART clock stops in power-down.
+  while (!txIdle()) {
+  }
+  g_rxWake = false;
+  PCIFR = _BV(VX8_RXD_PCIE);
+  VX8_RXD_PCMSK |= _BV(VX8_RXD_PCINT);
+  PCICR |= _BV(VX8_RXD_PCIE);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  while (ms >= kSliceMs && !g_rxWake) {
+    cli();
+    wdt_reset();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE);  // interrupt only, shortest timeout
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    if (!g_rxWake) {
+      g_sleptMs = g_sleptMs + kSliceMs;
+      ms = static_cast<uint16_t>(ms - kSliceMs);
+    }
+  }
+  wdt_disable();
+  PCICR &= static_cast<uint8_t>(~_BV(VX8_RXD_PCIE));
+  VX8_RXD_PCMSK &= static_cast<uint8_t>(~_BV(VX8_RXD_PCINT));
+}
+
+}  // namespace
+
+uint32_t clockMs() {
+  uint8_t sreg = SREG;
+  cli();
+  const uint32_t slept = g_sleptMs;
+  SREG = sreg;
+  return millis() + slept;
+}
+
+void sleep(const SleepRequest& request) {
+  if (request.mode == SleepMode::PowerDown) {
+    powerDown(request.ms);
+    return;
+  }
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+}
+
+}  // namespace avr
+}  // namespace vx8
+
+ISR(WDT_vect) {}
+
+ISR(VX8_RXD_VECT) { vx8::avr::g_rxWake = true; }
+
+#endif  // __AVR__
@@ -0,0 +1,38 @@
+// ATmega328P / ATmega2560 sleep for the power manager.
+//
+// Idle stops only the CPU clock: the USART and Timer0 keep running and any
+// interrupt wakes it. Power-down stops everything but the watchdog, which is
+// run in interrupt mode in ~16 ms slices; a pin-change interrupt on RXD ends
+// the sleep early if the GPS starts talking anyway (that first byte is
+// lost). Timer0 does not count while powered down, so clockMs() adds the
+// slept slices to millis(). An interrupted slice is not counted, which makes
+// the clock lag by up to 16 ms and the power manager wake early rather than
+// late.
+//
+// Defines the WDT and RXD pin-change vectors, so it cannot be combined with
+// SoftwareSerial or a watchdog reset in the same sketch.
+
+#ifndef VX8_AVR_POWER_H
+#define VX8_AVR_POWER_H
+
+#if defined(__AVR__)
+
+#include <stdint.h>
+
+#include "power_manager.h"
+
+namespace vx8 {
+namespace avr {
+
+// millis() plus the time spent powered down.
+uint32_t clockMs();
+
+// Sleeps as requested; call once per loop() after the power manager.
+void sleep(const SleepRequest& request);
+
+}  // namespace avr
+}  // namespace vx8
+
+#endif  // __AVR__
+
+#endif  // VX8_AVR_POWER_H
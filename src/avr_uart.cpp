@@ -0,0 +1,107 @@
+#if defined(__AVR__)
+
+#include "avr_uart.h"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+// The ATmega2560 numbers its vectors per USART; the 328P has only one.
+#if defined(USART0_RX_vect)
+#define VX8_RX_VECT USART0_RX_vect
+#define VX8_UDRE_VECT USART0_UDRE_vect
+#else
+#define VX8_RX_VECT USART_RX_vect
+#define VX8_UDRE_VECT USART_UDRE_vect
+#endif
+
+namespace vx8 {
+namespace avr {
+
+namespace {
+
+Bridge* g_bridge = 0;
+volatile bool g_sent = false;  // a byte went out since TXC0 was last clear
+
+void portWrite(void*, const uint8_t* data, uint8_t len) {
+  writeBlocking(data, len);
+}
+
+void portSetBaud(void*, uint32_t baud) { setBaud(baud); }
+
+}  // namespace
+
+void begin(Bridge& bridge, uint32_t baud) {
+  g_bridge = &bridge;
+  setBaud(baud);
+  UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);  // 8N1
+  UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+  sei();
+}
+
+void service() {
+  g_bridge->poll();
+  kick();
+}
+
+void kick() {
+  if (g_bridge->txPending()) UCSR0B |= _BV(UDRIE0);
+}
+
+bool txIdle() {
+  if (g_bridge->txPending() || (UCSR0B & _BV(UDRIE0))) return false;
+  return !g_sent || (UCSR0A & _BV(TXC0));
+}
+
+void setBaud(uint32_t baud) {
+  // Let the last byte leave the shift register first.
+  if (UCSR0B & _BV(TXEN0)) {
+    while (!(UCSR0A & _BV(UDRE0))) {
+    }
+  }
+  // Double-speed mode gives the smaller baud error at 9600 on 16 MHz.
+  const uint16_t ubrr = static_cast<uint16_t>((F_CPU / 4 / baud - 1) / 2);
+  UCSR0A = _BV(U2X0);
+  UBRR0H = static_cast<uint8_t>(ubrr >> 8);
+  UBRR0L = static_cast<uint8_t>(ubrr);
+}
+
+void writeBlocking(const uint8_t* data, uint8_t len) {
+  for (uint8_t i = 0; i < len; ++i) {
+    while (!(UCSR0A & _BV(UDRE0))) {
+    }
+    UDR0 = data[i];
+    UCSR0A |= _BV(TXC0);  // writing one clears it
+    g_sent = true;
+  }
+}
+
+ConfigPort configPort() {
+  ConfigPort port;
+  port.write = &portWrite;
+  port.setBaud = &portSetBaud;
+  port.ctx = 0;
+  return port;
+}
+
+}  // namespace avr
+}  // namespace vx8
+
+ISR(VX8_RX_VECT) {
+  const uint8_t status = UCSR0A;
+  const uint8_t b = UDR0;
+  if (status & _BV(FE0)) return;  // framing error: the byte is garbage
+  vx8::avr::g_bridge->onRxByte(b);
+}
+
+ISR(VX8_UDRE_VECT) {
+  uint8_t b;
+  if (vx8::avr::g_bridge->nextTxByte(b)) {
+    UDR0 = b;
+    UCSR0A |= _BV(TXC0);
+    vx8::avr::g_sent = true;
+  } else {
+    UCSR0B &= static_cast<uint8_t>(~_BV(UDRIE0));
+  }
+}
+
+#endif  // __AVR__
@@ -0,0 +1,48 @@
+// ATmega328P / ATmega2560 glue: runs USART0 full duplex for the bridge.
+//
+// The GPS module's TX line goes to RXD and the radio's GPS input to TXD, both
+// at the same baud rate, so a single hardware USART serves both directions
+// and neither side needs SoftwareSerial. The RX-complete interrupt feeds
+// Bridge::onRxByte(); the data-register-empty interrupt drains
+// Bridge::nextTxByte() and disables itself when the queue runs dry.
+//
+// These vectors clash with the Arduino core's HardwareSerial, so a sketch
+// using this must not reference `Serial`.
+
+#ifndef VX8_AVR_UART_H
+#define VX8_AVR_UART_H
+
+#if defined(__AVR__)
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "module_config.h"
+
+namespace vx8 {
+namespace avr {
+
+void begin(Bridge& bridge, uint32_t baud);
+
+// Main-loop step: polls the bridge and arms the transmitter if it has work.
+void service();
+
+// Arms the transmitter if the bridge has output.
+void kick();
+
+// Nothing queued and the last byte has left the shift register.
+bool txIdle();
+
+// Boot-time access for the module configurator. Received bytes keep going
+// into the bridge's buffer and are read back with Bridge::takeRxByte();
+// writes busy-wait and must not overlap with forwarding.
+void setBaud(uint32_t baud);
+void writeBlocking(const uint8_t* data, uint8_t len);
+ConfigPort configPort();
+
+}  // namespace avr
+}  // namespace vx8
+
+#endif  // __AVR__
+
+#endif  // VX8_AVR_UART_H
@@ -0,0 +1,71 @@
+// The board layer: UARTs, clock and sleep, and nothing else.
+//
+// The parser, bridge and filters never touch hardware. Everything that does
+// is behind these functions, and each board supplies them in one translation
+// unit that compiles only for that board:
+//   board_avr.cpp      ATmega328P/2560: one USART shared by the GPS (RXD) and
+//                      the radio (TXD), interrupt per byte
+//   board_hwserial.cpp SAMD21, RP2040, ESP32: separate UARTs for the GPS and
+//                      the radio; the core's interrupt/FIFO-fed serial
+//                      buffers are drained in bulk, so the module can run
+//                      at 115200 and 10 Hz
+//   board_linux.cpp    Linux: pipes, ptys or serial devices (board_linux.h)
+// Functions are bound at link time, not through virtual calls.
+//
+// On boards with their own UART per side, received bytes reach the bridge
+// in pump(), which therefore has to run often enough to keep the core's
+// buffer from filling up (see VX8_RX_BUFFER_SIZE).
+
+#ifndef VX8_BOARD_H
+#define VX8_BOARD_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "fix_log.h"
+#include "module_config.h"
+#include "power_manager.h"
+#include "pps_sync.h"
+
+namespace vx8 {
+namespace board {
+
+void begin(Bridge& bridge, uint32_t gpsBaud, uint32_t radioBaud);
+
+// True if the GPS and the radio share one UART: one baud rate, and anything
+// sent to the module also reaches the radio.
+bool sharedLine();
+
+// Moves received bytes into the bridge and the bridge's output to the radio
+// UART. Call after Bridge::poll(), and while configuring the module.
+void pump();
+
+// Nothing left to send and the last byte is on the wire.
+bool txIdle();
+
+// Writes to the GPS module and changes its baud rate (boot-time
+// configuration; may block).
+ConfigPort gpsPort();
+
+// Milliseconds, counting through sleep.
+uint32_t clockMs();
+// Microseconds, for timing the work between sleeps; wraps.
+uint32_t clockUs();
+
+// Calls pps.onPps() on each rising edge of VX8_PPS_PIN, from the pin's
+// interrupt.
+void attachPps(PpsSync& pps);
+
+// The medium for the track log (VX8_FIX_LOG): SPI flash or, with
+// VX8_LOG_SD, an SD card. A device with no pages if there is none. Arduino
+// boards define it only with VX8_FIX_LOG.
+LogDevice logDevice();
+
+// Sleeps as the power manager requests. Boards without a deep sleep that
+// preserves the clock wait in their lightest sleep instead.
+void sleep(const SleepRequest& request);
+
+}  // namespace board
+}  // namespace vx8
+
+#endif  // VX8_BOARD_H
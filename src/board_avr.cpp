@@ -0,0 +1,63 @@
+#if defined(__AVR__)
+
+#include "board.h"
+
+#include <Arduino.h>
+
+#include "avr_power.h"
+#include "avr_uart.h"
+#include "log_media.h"
+
+namespace vx8 {
+namespace board {
+
+namespace {
+
+PpsSync* g_pps = 0;
+
+void ppsEdge() { g_pps->onPps(); }
+
+}  // namespace
+
+// One USART for both sides, so the radio's baud rate wins; the module
+// configurator moves the module to it (VX8_GPS_BAUD).
+void begin(Bridge& bridge, uint32_t, uint32_t radioBaud) {
+  avr::begin(bridge, radioBaud);
+}
+
+bool sharedLine() { return true; }
+
+// RX is interrupt driven; only the transmitter needs arming.
+void pump() { avr::kick(); }
+
+bool txIdle() { return avr::txIdle(); }
+
+ConfigPort gpsPort() { return avr::configPort(); }
+
+uint32_t clockMs() { return avr::clockMs(); }
+
+uint32_t clockUs() { return micros(); }
+
+// External interrupts only wake the MCU from idle, not from power-down;
+// PpsSync::limit() keeps it idle when an edge is due.
+void attachPps(PpsSync& pps) {
+  g_pps = &pps;
+  attachInterrupt(digitalPinToInterrupt(VX8_PPS_PIN), ppsEdge, RISING);
+}
+
+#if VX8_FIX_LOG
+LogDevice logDevice() {
+#if VX8_LOG_SD
+  return sdCardLog(VX8_LOG_CS_PIN);
+#else
+  return spiFlashLog(VX8_LOG_CS_PIN);
+#endif
+}
+#endif
+
+void sleep(const SleepRequest& request) { avr::sleep(request); }
+
+}  // namespace board
+}  // namespace vx8
+
+#endif  // __AVR__
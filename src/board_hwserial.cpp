@@ -0,0 +1,181 @@
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_RP2040) || \
+    defined(ARDUINO_ARCH_ESP32)
+
+#include "board.h"
+
+#include <Arduino.h>
+
+#include "log_media.h"
+
+#if defined(ARDUINO_ARCH_SAMD)
+#include "wiring_private.h"
+#elif defined(ARDUINO_ARCH_ESP32)
+#include <esp_sleep.h>
+#endif
+
+// GPS and radio ports:
+//   SAMD21 (Zero, Feather M0)  GPS Serial1 (D0 RX, D1 TX), radio on SERCOM1
+//                              (D10 TX; D11 RX is unused)
+//   RP2040 (arduino-pico)      GPS Serial1 (GP1 RX, GP0 TX), radio Serial2
+//                              (GP4 TX; GP5 RX is unused)
+//   ESP32                      GPS Serial2, radio Serial1, pins from
+//                              VX8_ESP32_*_PIN
+#if defined(ARDUINO_ARCH_SAMD)
+Uart vx8RadioUart(&sercom1, 11, 10, SERCOM_RX_PAD_0, UART_TX_PAD_2);
+void SERCOM1_Handler() { vx8RadioUart.IrqHandler(); }
+#define VX8_GPS_SERIAL Serial1
+#define VX8_RADIO_SERIAL vx8RadioUart
+#elif defined(ARDUINO_ARCH_RP2040)
+#define VX8_GPS_SERIAL Serial1
+#define VX8_RADIO_SERIAL Serial2
+#else
+#define VX8_GPS_SERIAL Serial2
+#define VX8_RADIO_SERIAL Serial1
+#endif
+
+namespace vx8 {
+namespace board {
+
+namespace {
+
+Bridge* g_bridge = 0;
+int g_txRoom = 0;  // availableForWrite() with nothing queued
+PpsSync* g_pps = 0;
+
+void beginGps(uint32_t baud) {
+#if defined(ARDUINO_ARCH_ESP32)
+  VX8_GPS_SERIAL.begin(baud, SERIAL_8N1, VX8_ESP32_GPS_RX_PIN,
+                       VX8_ESP32_GPS_TX_PIN);
+#else
+  VX8_GPS_SERIAL.begin(baud);
+#endif
+}
+
+void idle() {
+#if defined(ARDUINO_ARCH_SAMD)
+  __WFI();  // SysTick and the SERCOM interrupts wake it
+#elif defined(ARDUINO_ARCH_RP2040)
+  __wfi();
+#else
+  delay(1);  // lets FreeRTOS idle, and light-sleep if power management is on
+#endif
+}
+
+void ppsEdge() { g_pps->onPps(); }
+
+void portWrite(void*, const uint8_t* data, uint8_t len) {
+  VX8_GPS_SERIAL.write(data, len);
+  VX8_GPS_SERIAL.flush();
+}
+
+void portSetBaud(void*, uint32_t baud) {
+  VX8_GPS_SERIAL.flush();
+#if defined(ARDUINO_ARCH_ESP32)
+  VX8_GPS_SERIAL.updateBaudRate(baud);
+#else
+  VX8_GPS_SERIAL.end();
+  beginGps(baud);
+#endif
+}
+
+}  // namespace
+
+void begin(Bridge& bridge, uint32_t gpsBaud, uint32_t radioBaud) {
+  g_bridge = &bridge;
+#if defined(ARDUINO_ARCH_RP2040)
+  VX8_GPS_SERIAL.setFIFOSize(VX8_HW_SERIAL_BUFFER);
+#elif defined(ARDUINO_ARCH_ESP32)
+  VX8_GPS_SERIAL.setRxBufferSize(VX8_HW_SERIAL_BUFFER);
+#endif
+  beginGps(gpsBaud);
+#if defined(ARDUINO_ARCH_ESP32)
+  VX8_RADIO_SERIAL.begin(radioBaud, SERIAL_8N1, VX8_ESP32_RADIO_RX_PIN,
+                         VX8_ESP32_RADIO_TX_PIN);
+#else
+#if defined(ARDUINO_ARCH_RP2040)
+  // arduino-pico puts Serial2 on GP8/GP9 unless told otherwise.
+  VX8_RADIO_SERIAL.setTX(4);
+  VX8_RADIO_SERIAL.setRX(5);
+#endif
+  VX8_RADIO_SERIAL.begin(radioBaud);
+#endif
+#if defined(ARDUINO_ARCH_SAMD)
+  pinPeripheral(10, PIO_SERCOM);
+  pinPeripheral(11, PIO_SERCOM);
+#endif
+  g_txRoom = VX8_RADIO_SERIAL.availableForWrite();
+}
+
+bool sharedLine() { return false; }
+
+void pump() {
+  // Only as much as the bridge has room for; the rest waits in the core's
+  // buffer instead of being counted as an overrun.
+  uint16_t room = static_cast<uint16_t>(Bridge::RxRing::capacity() -
+                                        g_bridge->rxUsed());
+  for (int n = VX8_GPS_SERIAL.available(); n > 0 && room; --n, --room) {
+    g_bridge->onRxByte(static_cast<uint8_t>(VX8_GPS_SERIAL.read()));
+  }
+  uint8_t b;
+  while (VX8_RADIO_SERIAL.availableForWrite() > 0 && g_bridge->nextTxByte(b)) {
+    VX8_RADIO_SERIAL.write(b);
+  }
+}
+
+bool txIdle() {
+  return !g_bridge->txPending() &&
+         VX8_RADIO_SERIAL.availableForWrite() >= g_txRoom;
+}
+
+ConfigPort gpsPort() {
+  ConfigPort port;
+  port.write = &portWrite;
+  port.setBaud = &portSetBaud;
+  port.ctx = 0;
+  return port;
+}
+
+uint32_t clockMs() { return millis(); }
+
+uint32_t clockUs() { return micros(); }
+
+void attachPps(PpsSync& pps) {
+  g_pps = &pps;
+  pinMode(VX8_PPS_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(VX8_PPS_PIN), ppsEdge, RISING);
+}
+
+#if VX8_FIX_LOG
+LogDevice logDevice() {
+#if VX8_LOG_SD
+  return sdCardLog(VX8_LOG_CS_PIN);
+#else
+  return spiFlashLog(VX8_LOG_CS_PIN);
+#endif
+}
+#endif
+
+void sleep(const SleepRequest& request) {
+  if (request.mode == SleepMode::Idle) {
+    idle();
+    return;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  // Light sleep stops the UARTs but not the clock behind millis().
+  VX8_RADIO_SERIAL.flush();
+  esp_sleep_enable_timer_wakeup(uint64_t(request.ms) * 1000);
+  esp_light_sleep_start();
+#else
+  // No deep sleep that keeps SysTick and the UART running: idle until the
+  // time is up or the GPS starts talking.
+  const uint32_t start = millis();
+  while (millis() - start < request.ms && !VX8_GPS_SERIAL.available()) {
+    idle();
+  }
+#endif
+}
+
+}  // namespace board
+}  // namespace vx8
+
+#endif  // ARDUINO_ARCH_SAMD || ARDUINO_ARCH_RP2040 || ARDUINO_ARCH_ESP32
@@ -0,0 +1,220 @@
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "board_linux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "log_media.h"
+
+namespace vx8 {
+namespace board {
+
+namespace {
+
+Bridge* g_bridge = 0;
+int g_gpsFd = -1;
+int g_radioFd = -1;
+bool g_inputClosed = false;
+PpsSync* g_pps = 0;
+uint64_t (*g_clock)() = 0;
+int g_logFd = -1;
+uint32_t g_logPages = 0;
+
+// Radio output the descriptor did not take yet.
+uint8_t g_out[256];
+size_t g_outLen = 0;
+
+speed_t speedFor(uint32_t baud) {
+  switch (baud) {
+    case 4800: return B4800;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    default: return B9600;
+  }
+}
+
+// Raw 8N1 at `baud` if `fd` is a terminal; pipes and files are left alone.
+void setupTerminal(int fd, uint32_t baud) {
+  termios t;
+  if (fd < 0 || tcgetattr(fd, &t) != 0) return;
+  cfmakeraw(&t);
+  cfsetispeed(&t, speedFor(baud));
+  cfsetospeed(&t, speedFor(baud));
+  tcsetattr(fd, TCSANOW, &t);
+}
+
+void setNonBlocking(int fd) {
+  if (fd < 0) return;
+  const int flags = fcntl(fd, F_GETFL);
+  if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+uint64_t monotonicNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000u + uint64_t(ts.tv_nsec);
+}
+
+// The firmware's clock (useClock()).
+uint64_t nowNs() { return g_clock ? g_clock() : monotonicNs(); }
+
+void flushOut() {
+  if (g_outLen == 0) return;
+  const ssize_t n = write(g_radioFd, g_out, g_outLen);
+  if (n > 0) {
+    g_outLen -= size_t(n);
+    memmove(g_out, g_out + n, g_outLen);
+  } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+    g_outLen = 0;  // nobody is listening; like an unplugged radio
+  }
+}
+
+void portWrite(void*, const uint8_t* data, uint8_t len) {
+  // A read-only GPS side (a pipe) just drops module commands.
+  while (len) {
+    const ssize_t n = write(g_gpsFd, data, len);
+    if (n > 0) {
+      data += n;
+      len = static_cast<uint8_t>(len - n);
+    } else if (n < 0 && errno == EAGAIN) {
+      pollfd p = {g_gpsFd, POLLOUT, 0};
+      poll(&p, 1, 10);
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return;
+    }
+  }
+}
+
+void portSetBaud(void*, uint32_t baud) {
+  tcdrain(g_gpsFd);
+  setupTerminal(g_gpsFd, baud);
+}
+
+}  // namespace
+
+void useFds(int gpsFd, int radioFd) {
+  g_gpsFd = gpsFd;
+  g_radioFd = radioFd;
+}
+
+int openPty(char* path, size_t size) {
+  const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0) return -1;
+  if (grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, path, size)) {
+    close(fd);
+    return -1;
+  }
+  setupTerminal(fd, 9600);
+  return fd;
+}
+
+bool inputClosed() { return g_inputClosed; }
+
+void pulsePps() {
+  if (g_pps) g_pps->onPps();
+}
+
+void useClock(uint64_t (*nowNs)()) { g_clock = nowNs; }
+
+void useLogFile(int fd, uint32_t pages) {
+  g_logFd = fd;
+  g_logPages = pages;
+}
+
+void begin(Bridge& bridge, uint32_t gpsBaud, uint32_t radioBaud) {
+  g_bridge = &bridge;
+  g_inputClosed = false;
+  g_outLen = 0;
+  setupTerminal(g_gpsFd, gpsBaud);
+  setupTerminal(g_radioFd, radioBaud);
+  setNonBlocking(g_gpsFd);
+  setNonBlocking(g_radioFd);
+}
+
+bool sharedLine() { return g_gpsFd == g_radioFd; }
+
+void pump() {
+  uint8_t buf[256];
+  bool received = false;
+  while (!g_inputClosed) {
+    const uint16_t room = static_cast<uint16_t>(Bridge::RxRing::capacity() -
+                                                g_bridge->rxUsed());
+    if (room == 0) break;
+    const ssize_t n =
+        read(g_gpsFd, buf, room < sizeof(buf) ? room : sizeof(buf));
+    // Closed only once everything before the end of file went through a
+    // poll, so inputClosed() means the bridge has seen all input.
+    if (n == 0 && !received) g_inputClosed = true;
+    if (n <= 0) break;
+    received = true;
+    for (ssize_t i = 0; i < n; ++i) g_bridge->onRxByte(buf[i]);
+  }
+  uint8_t b;
+  while (g_outLen < sizeof(g_out) && g_bridge->nextTxByte(b)) {
+    g_out[g_outLen++] = b;
+  }
+  flushOut();
+}
+
+bool txIdle() { return g_outLen == 0 && !g_bridge->txPending(); }
+
+ConfigPort gpsPort() {
+  ConfigPort port;
+  port.write = &portWrite;
+  port.setBaud = &portSetBaud;
+  port.ctx = 0;
+  return port;
+}
+
+uint32_t clockMs() { return static_cast<uint32_t>(nowNs() / 1000000); }
+
+uint32_t clockUs() { return static_cast<uint32_t>(nowNs() / 1000); }
+
+void attachPps(PpsSync& pps) { g_pps = &pps; }
+
+// 16 pages: a 4 KiB sector, as on the SPI flash chips.
+LogDevice logDevice() { return fileLog(g_logFd, g_logPages, 16); }
+
+// There is nothing to power down; both modes wait for input or for the
+// radio side to take more output, whichever comes first.
+void sleep(const SleepRequest& request) {
+  const int timeoutMs = request.mode == SleepMode::PowerDown ? request.ms : 1;
+  pollfd fds[2];
+  nfds_t n = 0;
+  if (!g_inputClosed) fds[n++] = {g_gpsFd, POLLIN, 0};
+  if (g_outLen) fds[n++] = {g_radioFd, POLLOUT, 0};
+  const uint64_t start = monotonicNs();
+  const int ready = n ? poll(fds, n, timeoutMs) : 0;
+  if (ready < 0 && errno == EINTR) return;  // e.g. a PPS edge (pulsePps())
+  // A pty with no one on the other side reports POLLHUP at once; still wait.
+  const bool input =
+      !g_inputClosed && ready > 0 && (fds[0].revents & POLLIN);
+  if (!input && !g_outLen) {
+    const uint64_t waited = monotonicNs() - start;
+    const uint64_t wanted = uint64_t(timeoutMs) * 1000000;
+    if (waited < wanted) {
+      timespec ts;
+      ts.tv_sec = time_t((wanted - waited) / 1000000000u);
+      ts.tv_nsec = long((wanted - waited) % 1000000000u);
+      nanosleep(&ts, 0);
+    }
+  }
+}
+
+}  // namespace board
+}  // namespace vx8
+
+#endif  // __linux__ && !ARDUINO
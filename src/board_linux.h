@@ -0,0 +1,48 @@
+// Linux as a board (board.h): the GPS and the radio are file descriptors,
+// so the firmware runs unchanged against pipes, pseudo-terminals or real
+// serial adapters. Used by the host tests and tools/vx8_bridge.cpp.
+
+#ifndef VX8_BOARD_LINUX_H
+#define VX8_BOARD_LINUX_H
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vx8 {
+namespace board {
+
+// The GPS side is read from `gpsFd`, and module commands are written to it
+// when it is writable; output for the radio goes to `radioFd`. Call before
+// begin(). Terminals are switched to raw mode at the baud rates passed to
+// begin(); pipes ignore baud rates.
+void useFds(int gpsFd, int radioFd);
+
+// Opens a pseudo-terminal in raw mode. Returns the master side's descriptor
+// (for useFds) and writes the slave's path to `path`, or returns -1.
+int openPty(char* path, size_t size);
+
+// The GPS side has reached end of file (a pipe whose writer is gone) and
+// everything before it has been handed to the bridge.
+bool inputClosed();
+
+// A PPS edge (see attachPps()). There is no pin to watch; tests and tools
+// call this, e.g. from a signal handler, which it is safe to do.
+void pulsePps();
+
+// Tests: clockMs() and clockUs() read `nowNs` (nanoseconds) instead of the
+// monotonic clock, so timeouts only pass when the test says so; null goes
+// back to the real clock. sleep() still waits in real time.
+void useClock(uint64_t (*nowNs)());
+
+// Keeps the track log (logDevice()) in `pages` 256-byte pages of the file
+// `fd`, erased 4 KiB at a time like SPI flash. Call before begin().
+void useLogFile(int fd, uint32_t pages);
+
+}  // namespace board
+}  // namespace vx8
+
+#endif  // __linux__ && !ARDUINO
+
+#endif  // VX8_BOARD_LINUX_H
@@ -0,0 +1,148 @@
+#include "bridge.h"
+
+#include <string.h>
+
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+Bridge::Bridge()
+    : filter_(0),
+      filterCtx_(0),
+      scan_(0),
+      sentenceStart_(0),
+      txPos_(0),
+      txActive_(false),
+      injectData_(inject_),
+      injectLen_(0),
+      injectPos_(0) {
+  memset(&stats_, 0, sizeof(stats_));
+  txSpan_.start = 0;
+  txSpan_.length = 0;
+}
+
+void Bridge::setFilter(SentenceFilter filter, void* ctx) {
+  filter_ = filter;
+  filterCtx_ = ctx;
+}
+
+bool Bridge::nextTxByte(uint8_t& out) {
+  if (!txActive_ && injectLen_) {
+    out = injectData_[injectPos_];
+    if (++injectPos_ == injectLen_) {
+      injectPos_ = 0;
+      VX8_BARRIER();
+      injectLen_ = 0;
+    }
+    ++stats_.bytesOut;
+    return true;
+  }
+  if (!txActive_) {
+    if (!tx_.peek(txSpan_)) return false;
+    txPos_ = 0;
+    txActive_ = true;
+  }
+  if (txPos_ < txSpan_.length) {
+    out = rx_.at(txSpan_.start + txPos_);
+  } else {
+    out = txPos_ == txSpan_.length ? '\r' : '\n';
+  }
+  if (++txPos_ == txSpan_.length + 2) {
+    txActive_ = false;
+    tx_.drop();
+  }
+  ++stats_.bytesOut;
+  return true;
+}
+
+bool Bridge::poll() {
+  const RxRing::Index head = rx_.headIndex();
+  const uint16_t used = rx_.size();
+  if (used > stats_.rxHighWater) stats_.rxHighWater = used;
+
+  RxRing::Index scan = scan_;
+  while (scan != head) {
+    const uint8_t c = rx_.at(scan);
+    if (c == '$') sentenceStart_ = scan;
+    scan = RxRing::wrap(scan + 1);
+    ++stats_.bytesIn;
+
+    switch (parser_.feed(c)) {
+      case NmeaParser::Status::Sentence:
+        queueSentence();
+        break;
+      case NmeaParser::Status::Error:
+        ++stats_.parseErrors;
+        if (parser_.lastError() == NmeaParser::Error::Checksum) {
+          ++stats_.checksumErrors;
+        }
+        break;
+      case NmeaParser::Status::Busy:
+        break;
+    }
+  }
+  scan_ = scan;
+  releaseRx();
+  return txPending();
+}
+
+bool Bridge::inject(const uint8_t* data, uint8_t len) {
+  if (injectLen_ || len > kMaxInject) return false;
+  memcpy(inject_, data, len);
+  injectData_ = inject_;
+  VX8_BARRIER();
+  injectLen_ = len;
+  return true;
+}
+
+bool Bridge::injectBuffer(const uint8_t* data, uint8_t len) {
+  if (injectLen_) return false;
+  injectData_ = data;
+  VX8_BARRIER();
+  injectLen_ = len;
+  return true;
+}
+
+bool Bridge::takeRxByte(uint8_t& out) {
+  if (!rx_.pop(out)) return false;
+  scan_ = rx_.tailIndex();
+  return true;
+}
+
+void Bridge::queueSentence() {
+  SentenceView raw(&rx_.at(0), RxRing::kMask, sentenceStart_,
+                   parser_.length(), parser_.checksumOffset());
+  if (filter_ && !filter_(filterCtx_, parser_, raw)) {
+    ++stats_.sentencesFiltered;
+    return;
+  }
+  TxSpan span;
+  span.start = sentenceStart_;
+  span.length = raw.length();
+  if (!tx_.push(span)) {
+    ++stats_.txQueueFull;
+    return;
+  }
+  const uint8_t queued = static_cast<uint8_t>(tx_.size());
+  if (queued > stats_.txHighWater) stats_.txHighWater = queued;
+  ++stats_.sentencesForwarded;
+}
+
+// Hands receive space back to the RX interrupt, up to the oldest byte that is
+// still needed: a sentence queued for the radio, then the sentence being
+// parsed, then anything not yet scanned. Reading tx_'s tail races with the TX
+// interrupt dropping it, but a stale answer only releases less than it could.
+void Bridge::releaseRx() {
+  RxRing::Index keep;
+  const TxQueue::Index t = tx_.tailIndex();
+  if (t != tx_.headIndex()) {
+    keep = RxRing::wrap(tx_.at(t).start);
+  } else if (parser_.inSentence()) {
+    keep = sentenceStart_;
+  } else {
+    keep = scan_;
+  }
+  rx_.releaseTo(keep);
+}
+
+}  // namespace vx8
@@ -0,0 +1,137 @@
+// GPS-to-radio forwarding core.
+//
+// Bytes from the GPS arrive in an interrupt and are pushed into rx_. The main
+// loop calls poll(), which runs them through the NMEA parser. When a sentence
+// passes its checksum (and the optional filter), poll() queues its index
+// range in the receive buffer on tx_; the radio-side transmit interrupt then
+// reads the bytes straight out of rx_ and appends CR LF. Nothing is copied on
+// the way to the radio, and receive space is only handed back to the RX
+// interrupt once the transmitter is done with it.
+//
+// The main loop can also inject a short raw message (a command for the GPS
+// module on a shared TX line, a status reply); it is sent between sentences,
+// as is, from its own small buffer, or from the caller's buffer when the
+// message is longer (injectBuffer()).
+//
+// Each piece of shared state has exactly one writer:
+//   RX interrupt   rx_ head, stats_.rxOverruns
+//   main loop      rx_ tail, tx_ head, inject_, injectData_ and injectLen_
+//                  while it is 0,
+//                  everything else in stats_
+//   TX interrupt   tx_ tail, txSpan_/txPos_/txActive_, injectPos_,
+//                  injectLen_ back to 0, stats_.bytesOut
+
+#ifndef VX8_BRIDGE_H
+#define VX8_BRIDGE_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+#include "ring_buffer.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+// A sentence waiting for the radio: `length` bytes of the receive buffer
+// starting at `start` ('$' through the checksum digits).
+struct TxSpan {
+  uint16_t start;
+  uint8_t length;
+};
+
+struct BridgeStats {
+  uint32_t bytesIn;
+  uint32_t bytesOut;
+  uint16_t rxOverruns;          // bytes lost because rx_ was full
+  uint16_t rxHighWater;         // most bytes ever waiting in rx_
+  uint8_t txHighWater;          // most sentences ever queued on tx_
+  uint16_t sentencesForwarded;
+  uint16_t sentencesFiltered;   // valid, but rejected by the filter
+  uint16_t parseErrors;         // checksum, framing and overflow errors
+  uint16_t checksumErrors;      // of which checksum mismatches
+  uint16_t txQueueFull;         // valid sentences dropped for lack of a slot
+};
+
+class Bridge {
+ public:
+  typedef SpscRing<uint8_t, VX8_RX_BUFFER_SIZE> RxRing;
+  typedef SpscRing<TxSpan, VX8_TX_QUEUE_SIZE> TxQueue;
+
+  static const uint8_t kMaxInject = 64;
+
+  // Decides whether a checksum-valid sentence goes to the radio. `raw` is
+  // the sentence's bytes in the receive buffer and may be rewritten in
+  // place; `sentence` still reflects what was received.
+  typedef bool (*SentenceFilter)(void* ctx, const NmeaParser& sentence,
+                                 SentenceView& raw);
+
+  Bridge();
+
+  void setFilter(SentenceFilter filter, void* ctx);
+  SentenceFilter filter() const { return filter_; }
+  void* filterContext() const { return filterCtx_; }
+
+  // RX interrupt: one byte from the GPS.
+  void onRxByte(uint8_t b) {
+    if (!rx_.push(b)) ++stats_.rxOverruns;
+  }
+
+  // TX interrupt: fetches the next byte for the radio. Returns false when
+  // there is nothing to send, in which case the caller should disable its
+  // transmit-ready interrupt until poll() reports more work.
+  bool nextTxByte(uint8_t& out);
+
+  // Main loop: parses everything received so far and queues valid
+  // sentences. Returns true while output is pending for the radio.
+  bool poll();
+
+  // Main loop, before forwarding starts (e.g. while configuring the GPS
+  // module): takes one raw byte out of the receive buffer, bypassing the
+  // parser. Do not mix with poll() while a sentence is being parsed.
+  bool takeRxByte(uint8_t& out);
+
+  // Main loop: queues `len` raw bytes for the radio side, ahead of the next
+  // sentence. Returns false if an earlier injection is still going out or
+  // the message is longer than kMaxInject.
+  bool inject(const uint8_t* data, uint8_t len);
+  // Same, but sends `data` in place instead of copying it, so there is no
+  // length limit; the bytes must stay unchanged while injectPending().
+  bool injectBuffer(const uint8_t* data, uint8_t len);
+  bool injectPending() const { return injectLen_ != 0; }
+
+  bool txPending() const { return !tx_.empty() || injectLen_ != 0; }
+
+  // Bytes received but not yet handed back to the RX interrupt.
+  uint16_t rxUsed() const { return rx_.size(); }
+
+  const BridgeStats& stats() const { return stats_; }
+  const NmeaParser& parser() const { return parser_; }
+
+ private:
+  void queueSentence();
+  void releaseRx();
+
+  RxRing rx_;
+  TxQueue tx_;
+  NmeaParser parser_;
+  SentenceFilter filter_;
+  void* filterCtx_;
+  BridgeStats stats_;
+
+  RxRing::Index scan_;           // next byte for the parser
+  RxRing::Index sentenceStart_;  // '$' of the sentence being parsed
+
+  TxSpan txSpan_;
+  uint8_t txPos_;
+  volatile bool txActive_;
+
+  uint8_t inject_[kMaxInject];
+  const uint8_t* injectData_;  // inject_ or the caller's buffer
+  volatile uint8_t injectLen_;
+  uint8_t injectPos_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_BRIDGE_H
@@ -0,0 +1,24 @@
+#include "filter_chain.h"
+
+namespace vx8 {
+
+bool FilterChain::add(Bridge::SentenceFilter filter, void* ctx) {
+  if (count_ == kMaxStages) return false;
+  stages_[count_].filter = filter;
+  stages_[count_].ctx = ctx;
+  ++count_;
+  return true;
+}
+
+bool FilterChain::apply(const NmeaParser& p, SentenceView& raw) {
+  for (uint8_t i = 0; i < count_; ++i) {
+    if (!stages_[i].filter(stages_[i].ctx, p, raw)) return false;
+  }
+  return true;
+}
+
+bool FilterChain::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<FilterChain*>(ctx)->apply(p, raw);
+}
+
+}  // namespace vx8
@@ -0,0 +1,41 @@
+// Runs several sentence filters in order behind the bridge's single filter
+// hook, e.g. the output profile followed by the motion filter. A sentence
+// goes to the radio only if every stage accepts it; later stages see the
+// edits made by earlier ones in `raw`.
+
+#ifndef VX8_FILTER_CHAIN_H
+#define VX8_FILTER_CHAIN_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+
+namespace vx8 {
+
+class FilterChain {
+ public:
+  static const uint8_t kMaxStages = 6;
+
+  FilterChain() : count_(0) {}
+
+  // Appends a stage. Returns false when the chain is full.
+  bool add(Bridge::SentenceFilter filter, void* ctx);
+
+  bool apply(const NmeaParser& p, SentenceView& raw);
+
+  // Bridge::SentenceFilter adaptor; `ctx` is the FilterChain.
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+ private:
+  struct Stage {
+    Bridge::SentenceFilter filter;
+    void* ctx;
+  };
+
+  Stage stages_[kMaxStages];
+  uint8_t count_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_FILTER_CHAIN_H
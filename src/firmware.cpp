@@ -0,0 +1,50 @@
+#include "firmware.h"
+
+#include "board.h"
+#include "module_config.h"
+
+namespace vx8 {
+
+void Firmware::setup(bool configure) {
+  Bridge& bridge = pipeline_.bridge();
+  board::begin(bridge, VX8_GPS_BAUD, VX8_RADIO_BAUD);
+  if (configure) pipeline_.power().setModule(configureModule());
+  if (!board::sharedLine()) pipeline_.power().setModulePort(board::gpsPort());
+#if VX8_FIX_LOG
+  pipeline_.logger().begin(board::logDevice());
+#endif
+  pipeline_.begin();
+#if VX8_PPS_SYNC
+  board::attachPps(pipeline_.pps());
+#endif
+}
+
+void Firmware::loop() {
+  Monitor& monitor = pipeline_.monitor();
+  monitor.beginLoop(board::clockUs());
+  board::pump();
+  pipeline_.bridge().poll();
+  const SleepRequest request = pipeline_.update(board::clockMs());
+  board::pump();
+  monitor.endLoop(board::clockUs());
+  board::sleep(request);
+}
+
+GpsModule Firmware::configureModule() {
+  ModuleConfigurator config(board::gpsPort(),
+                            ModuleConfigOptions::defaults());
+  SleepRequest idle;
+  idle.mode = SleepMode::Idle;
+  idle.ms = 0;
+  config.begin(board::clockMs());
+  while (config.poll(board::clockMs()) ==
+         ModuleConfigurator::Result::Pending) {
+    board::pump();
+    uint8_t b;
+    while (pipeline_.bridge().takeRxByte(b)) config.onRxByte(b);
+    board::sleep(idle);
+  }
+  return config.module();
+}
+
+}  // namespace vx8
@@ -0,0 +1,50 @@
+// The complete bridge as the example sketch runs it, on any board (board.h):
+// boot-time module configuration, then the pipeline (pipeline.h) of the
+// diagnostics monitor, output profile, motion filter and power manager in
+// front of the radio (and the track log with VX8_FIX_LOG, and the PPS
+// alignment with VX8_PPS_SYNC), and a main loop that sleeps between bursts.
+
+#ifndef VX8_FIRMWARE_H
+#define VX8_FIRMWARE_H
+
+#include <stdint.h>
+
+#include "board.h"
+#include "pipeline.h"
+
+namespace vx8 {
+
+class Firmware {
+ public:
+  // Starts the UARTs and, if asked to, configures the GPS module first,
+  // which takes a few seconds; the radio sees nothing until it is done.
+  void setup(bool configureModule = true);
+
+  // One pass of the main loop, ending in a sleep.
+  void loop();
+
+  // Everything queued for the radio, reports and held fixes included, has
+  // been sent.
+  bool drained() const {
+    return board::txIdle() && !pipeline_.outputPending();
+  }
+
+  Bridge& bridge() { return pipeline_.bridge(); }
+  Monitor& monitor() { return pipeline_.monitor(); }
+  PowerManager& power() { return pipeline_.power(); }
+#if VX8_FIX_LOG
+  FixLogger& logger() { return pipeline_.logger(); }
+#endif
+#if VX8_PPS_SYNC
+  PpsSync& pps() { return pipeline_.pps(); }
+#endif
+
+ private:
+  GpsModule configureModule();
+
+  Pipeline pipeline_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_FIRMWARE_H
@@ -0,0 +1,297 @@
+#include "fix_log.h"
+
+#include <string.h>
+
+namespace vx8 {
+
+static_assert(FixLog::kHeaderSize +
+                      FixLog::kRecordsPerPage * FixRecord::kSize <=
+                  FixLog::kPageSize,
+              "records must fit a page");
+
+namespace {
+
+const uint8_t kMagic0 = 'V';
+const uint8_t kMagic1 = 'L';
+const uint32_t kSecondsPerDay = 86400;
+
+// CRC-8, polynomial 0x07.
+uint8_t crc8(const uint8_t* data, uint8_t len) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; ++b) {
+      crc = static_cast<uint8_t>(crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+  }
+  return crc;
+}
+
+void put16(uint8_t* out, uint16_t v) {
+  out[0] = static_cast<uint8_t>(v);
+  out[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t* out, uint32_t v) {
+  put16(out, static_cast<uint16_t>(v));
+  put16(out + 2, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t get16(const uint8_t* in) {
+  return static_cast<uint16_t>(in[0] | in[1] << 8);
+}
+
+uint32_t get32(const uint8_t* in) {
+  return get16(in) | static_cast<uint32_t>(get16(in + 2)) << 16;
+}
+
+bool leapYear(uint8_t year) { return year % 4 == 0; }  // 2000-2099
+
+uint8_t daysInMonth(uint8_t year, uint8_t month) {
+  static const uint8_t kDays[12] = {31, 28, 31, 30, 31, 30,
+                                    31, 31, 30, 31, 30, 31};
+  return static_cast<uint8_t>(kDays[month - 1] +
+                              (month == 2 && leapYear(year) ? 1 : 0));
+}
+
+}  // namespace
+
+void FixRecord::encode(uint8_t* out) const {
+  put32(out, time);
+  put32(out + 4, static_cast<uint32_t>(latitude));
+  put32(out + 8, static_cast<uint32_t>(longitude));
+  put16(out + 12, speed);
+  put16(out + 14, course);
+  put16(out + 16, hdop);
+  out[18] = satellites;
+  out[19] = crc8(out, kSize - 1);
+}
+
+bool FixRecord::decode(const uint8_t* in) {
+  if (crc8(in, kSize - 1) != in[kSize - 1]) return false;
+  time = get32(in);
+  latitude = static_cast<int32_t>(get32(in + 4));
+  longitude = static_cast<int32_t>(get32(in + 8));
+  speed = get16(in + 12);
+  course = get16(in + 14);
+  hdop = get16(in + 16);
+  satellites = in[18];
+  return true;
+}
+
+uint32_t logTime(const UtcDate& date, const UtcTime& time) {
+  uint32_t days = 365U * date.year + (date.year + 3U) / 4U;
+  for (uint8_t m = 1; m < date.month; ++m) days += daysInMonth(date.year, m);
+  days += date.day - 1U;
+  return days * kSecondsPerDay + time.secondOfDay();
+}
+
+void splitLogTime(uint32_t t, UtcDate& date, UtcTime& time) {
+  uint32_t days = t / kSecondsPerDay;
+  uint32_t s = t % kSecondsPerDay;
+  time.hour = static_cast<uint8_t>(s / 3600);
+  s %= 3600;
+  time.minute = static_cast<uint8_t>(s / 60);
+  time.second = static_cast<uint8_t>(s % 60);
+  time.centisecond = 0;
+  date.year = 0;
+  while (days >= (leapYear(date.year) ? 366U : 365U)) {
+    days -= leapYear(date.year) ? 366U : 365U;
+    ++date.year;
+  }
+  date.month = 1;
+  while (days >= daysInMonth(date.year, date.month)) {
+    days -= daysInMonth(date.year, date.month);
+    ++date.month;
+  }
+  date.day = static_cast<uint8_t>(days + 1);
+}
+
+FixLog::FixLog()
+    : count_(0),
+      flush_(false),
+      erased_(false),
+      haveOldest_(false),
+      head_(0),
+      oldest_(0),
+      sequence_(0),
+      dropped_(0),
+      errors_(0) {
+  memset(&device_, 0, sizeof(device_));
+  memset(page_, 0xFF, sizeof(page_));
+}
+
+bool FixLog::begin(const LogDevice& device) {
+  device_ = device;
+  if (device_.pagesPerBlock == 0 || device_.pages % device_.pagesPerBlock) {
+    device_.pages = 0;
+  }
+  haveOldest_ = false;
+  bool found = false;
+  uint32_t newest = 0;
+  uint32_t newestSeq = 0;
+  uint32_t oldestSeq = 0;
+  for (uint32_t p = 0; p < device_.pages; ++p) {
+    uint8_t raw[kHeaderSize];
+    if (!device_.read(device_.ctx, p, 0, raw, kHeaderSize)) {
+      ++errors_;
+      device_.pages = 0;
+      return false;
+    }
+    PageHeader h;
+    if (!parseHeader(raw, h)) continue;
+    if (!found || h.sequence > newestSeq) {
+      newest = p;
+      newestSeq = h.sequence;
+    }
+    if (!found || h.sequence < oldestSeq) {
+      oldest_ = p;
+      oldestSeq = h.sequence;
+    }
+    found = true;
+  }
+  if (!enabled()) return false;
+
+  head_ = 0;
+  sequence_ = 0;
+  erased_ = false;
+  if (found) {
+    haveOldest_ = true;
+    head_ = wrap(newest + 1);
+    sequence_ = newestSeq + 1;
+    // The rest of the newest page's block was erased with it, unless a
+    // reset cut a write short there; then the block is given up.
+    if (head_ % device_.pagesPerBlock) {
+      erased_ = blank(head_);
+      if (!erased_) {
+        head_ = wrap(head_ + device_.pagesPerBlock -
+                     head_ % device_.pagesPerBlock);
+      }
+    }
+  }
+  return true;
+}
+
+bool FixLog::readHeader(uint32_t page, PageHeader& h) const {
+  uint8_t raw[kHeaderSize];
+  return device_.read(device_.ctx, page, 0, raw, kHeaderSize) &&
+         parseHeader(raw, h);
+}
+
+bool FixLog::parseHeader(const uint8_t* raw, PageHeader& h) {
+  if (raw[0] != kMagic0 || raw[1] != kMagic1 ||
+      crc8(raw, kHeaderSize - 1) != raw[kHeaderSize - 1]) {
+    return false;
+  }
+  h.sequence = get32(raw + 2);
+  h.count = raw[6];
+  return h.count >= 1 && h.count <= kRecordsPerPage;
+}
+
+// Uses the page buffer, so only while no records are waiting.
+bool FixLog::blank(uint32_t page) {
+  if (!device_.read(device_.ctx, page, 0, page_, kPageSize)) return false;
+  bool empty = true;
+  for (uint16_t i = 0; i < kPageSize; ++i) empty = empty && page_[i] == 0xFF;
+  memset(page_, 0xFF, sizeof(page_));
+  return empty;
+}
+
+bool FixLog::append(const FixRecord& r) {
+  if (!enabled()) return false;
+  if (count_ == kRecordsPerPage) {
+    ++dropped_;
+    return false;
+  }
+  r.encode(page_ + kHeaderSize + count_ * FixRecord::kSize);
+  ++count_;
+  return true;
+}
+
+void FixLog::update() {
+  if (!enabled() || (count_ < kRecordsPerPage && !flush_)) return;
+  if (device_.busy(device_.ctx)) return;
+  if (!erased_) {
+    startBlock();
+  } else {
+    writePage();
+  }
+}
+
+// Erases the block at head_. If the start of the log is in it, the log now
+// starts with the next block.
+void FixLog::startBlock() {
+  const uint32_t block = head_ / device_.pagesPerBlock;
+  if (haveOldest_ && oldest_ / device_.pagesPerBlock == block) {
+    oldest_ = wrap((block + 1) * device_.pagesPerBlock);
+  }
+  if (!device_.erase(device_.ctx, block)) ++errors_;
+  erased_ = true;
+}
+
+void FixLog::writePage() {
+  page_[0] = kMagic0;
+  page_[1] = kMagic1;
+  put32(page_ + 2, sequence_);
+  page_[6] = count_;
+  page_[7] = crc8(page_, kHeaderSize - 1);
+  if (!device_.program(device_.ctx, head_, page_)) ++errors_;
+  if (!haveOldest_) {
+    haveOldest_ = true;
+    oldest_ = head_;
+  }
+  ++sequence_;
+  head_ = wrap(head_ + 1);
+  erased_ = head_ % device_.pagesPerBlock != 0;
+  count_ = 0;
+  flush_ = false;
+  memset(page_, 0xFF, sizeof(page_));
+}
+
+// The first page from `from` on whose header is valid and, unless `any`,
+// carries a sequence number above `after`. Pages are written in order, so
+// from the page after the cursor that is the next one written, even past a
+// page whose program failed.
+bool FixLog::findPage(uint32_t from, uint32_t after, bool any,
+                      LogCursor& c) const {
+  uint32_t p = from;
+  for (uint32_t n = 0; n < device_.pages; ++n, p = wrap(p + 1)) {
+    PageHeader h;
+    if (readHeader(p, h) && (any || h.sequence > after)) {
+      c.page = p;
+      c.sequence = h.sequence;
+      c.index = 0;
+      c.started = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FixLog::next(LogCursor& c, FixRecord& out) const {
+  if (!enabled() || !haveOldest_) return false;
+  if (!c.started && !findPage(oldest_, 0, true, c)) return false;
+  for (uint32_t n = 0; n <= device_.pages; ++n) {
+    PageHeader h;
+    if (!readHeader(c.page, h) || h.sequence != c.sequence) {
+      // Erased under the cursor: start again from what is left.
+      if (!findPage(oldest_, 0, true, c)) return false;
+      continue;
+    }
+    while (c.index < h.count) {
+      uint8_t raw[FixRecord::kSize];
+      const uint8_t offset =
+          static_cast<uint8_t>(kHeaderSize + c.index * FixRecord::kSize);
+      ++c.index;
+      if (device_.read(device_.ctx, c.page, offset, raw, FixRecord::kSize) &&
+          out.decode(raw)) {
+        return true;
+      }
+    }
+    if (c.sequence + 1 == sequence_) return false;
+    if (!findPage(wrap(c.page + 1), c.sequence, false, c)) return false;
+  }
+  return false;
+}
+
+}  // namespace vx8
@@ -0,0 +1,152 @@
+// Track log storage: fixed-size binary fix records in a circular log on SPI
+// NOR flash or an SD card.
+//
+// The medium is seen as 256-byte pages, erased in blocks of pagesPerBlock
+// pages (a 4 KiB sector on NOR flash; 1 with nothing to erase, as on SD).
+// Each page holds an 8-byte header and up to kRecordsPerPage records:
+//   0  'V' 'L'
+//   2  sequence number, uint32 little-endian, one more than the page before
+//      (more after a failed program)
+//   6  record count, 1..kRecordsPerPage
+//   7  CRC-8 of bytes 0..6
+//   8  records, FixRecord::kSize bytes each; the rest stays 0xFF
+//
+// Records collect in RAM and a page is written only when it is full (or on
+// flush()), so every page is programmed exactly once between erases. Pages
+// are written in order around the medium, and a block is erased just
+// before its first page is reused, which drops the oldest block of the log
+// and wears every block evenly. Nothing is kept anywhere else: begin()
+// finds the newest page by its sequence number after a reset, and a page
+// cut short by a reset fails its header CRC (and its block is skipped).
+//
+// Writing never waits for the device: update() starts at most one erase or
+// page program per call and returns while the device is busy, so the main
+// loop keeps forwarding during a 50 ms sector erase. An SD card (log_media.h)
+// is the exception: its program() returns only once the card has written
+// the page, so FixLogger calls update() only between GPS bursts.
+
+#ifndef VX8_FIX_LOG_H
+#define VX8_FIX_LOG_H
+
+#include <stdint.h>
+
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+// One fix, stored as 20 little-endian bytes ending in a CRC-8 of the others.
+struct FixRecord {
+  uint32_t time;        // seconds since 2000-01-01 00:00:00 UTC
+  int32_t latitude;     // 1e-5 arc-minutes, north positive
+  int32_t longitude;    // 1e-5 arc-minutes, east positive
+  uint16_t speed;       // centi-knots
+  uint16_t course;      // centi-degrees, kNoValue16 when absent
+  uint16_t hdop;        // hundredths, kNoValue16 when absent
+  uint8_t satellites;
+
+  static const uint8_t kSize = 20;
+
+  void encode(uint8_t* out) const;
+  // False if the CRC does not match (an erased or damaged record).
+  bool decode(const uint8_t* in);
+};
+
+// RMC date and time <-> FixRecord::time. Two-digit years are 2000-2099.
+uint32_t logTime(const UtcDate& date, const UtcTime& time);
+void splitLogTime(uint32_t t, UtcDate& date, UtcTime& time);
+
+// The storage medium. Operations return false on a device error.
+// program() takes all 256 bytes before it returns, but like erase() it may
+// return before the device has finished; busy() reports when it has, and
+// nothing else is called meanwhile.
+struct LogDevice {
+  bool (*read)(void* ctx, uint32_t page, uint8_t offset, uint8_t* data,
+               uint16_t len);
+  bool (*program)(void* ctx, uint32_t page, const uint8_t* data);
+  bool (*erase)(void* ctx, uint32_t block);
+  bool (*busy)(void* ctx);
+  void* ctx;
+  uint32_t pages;          // a multiple of pagesPerBlock; 0: no device
+  uint16_t pagesPerBlock;
+};
+
+// Position of a reader in the log, oldest record first.
+struct LogCursor {
+  uint32_t page;
+  uint32_t sequence;  // of `page`, to notice it being erased under us
+  uint8_t index;      // next record in the page
+  bool started;
+};
+
+class FixLog {
+ public:
+  static const uint16_t kPageSize = 256;
+  static const uint8_t kHeaderSize = 8;
+  static const uint8_t kRecordsPerPage =
+      (kPageSize - kHeaderSize) / FixRecord::kSize;
+
+  FixLog();
+
+  // Scans the device and continues after the newest page. Returns false
+  // (and stays disabled) if the device has no pages or cannot be read.
+  bool begin(const LogDevice& device);
+  bool enabled() const { return device_.pages != 0; }
+
+  // Adds a record to the page being collected. Returns false, dropping it,
+  // if a full page is still waiting for update() to write it.
+  bool append(const FixRecord& r);
+
+  // Writes the records collected so far as a short page on a later
+  // update(), e.g. before reading the log back.
+  void flush() { flush_ = count_ != 0; }
+  // No records waiting in RAM.
+  bool flushed() const { return count_ == 0; }
+
+  // Main loop: starts the next erase or page program if one is due and the
+  // device is idle.
+  void update();
+
+  // The device can be read now (not busy erasing or programming).
+  bool ready() const { return enabled() && !device_.busy(device_.ctx); }
+
+  // Reading, oldest first, from the pages written so far (flush() first to
+  // include the newest records); only while ready(). Returns false at the
+  // end, and carries on from there once more pages are written. A cursor
+  // overtaken by the writer skips ahead to the oldest page still there.
+  void rewind(LogCursor& c) const { c.started = false; }
+  bool next(LogCursor& c, FixRecord& out) const;
+
+  uint32_t sequence() const { return sequence_; }  // next page to write
+  uint16_t dropped() const { return dropped_; }
+  uint16_t deviceErrors() const { return errors_; }
+
+ private:
+  struct PageHeader {
+    uint32_t sequence;
+    uint8_t count;
+  };
+
+  static bool parseHeader(const uint8_t* raw, PageHeader& h);
+  bool readHeader(uint32_t page, PageHeader& h) const;
+  bool blank(uint32_t page);
+  uint32_t wrap(uint32_t page) const { return page % device_.pages; }
+  bool findPage(uint32_t from, uint32_t after, bool any, LogCursor& c) const;
+  void startBlock();
+  void writePage();
+
+  LogDevice device_;
+  uint8_t page_[kPageSize];
+  uint8_t count_;
+  bool flush_;
+  bool erased_;  // the block at head_ is ready for programming
+  bool haveOldest_;
+  uint32_t head_;    // next page to program
+  uint32_t oldest_;  // where the log starts
+  uint32_t sequence_;
+  uint16_t dropped_;
+  uint16_t errors_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_FIX_LOG_H
@@ -0,0 +1,121 @@
+#include "fix_logger.h"
+
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+FixLogger::FixLogger(uint8_t intervalS)
+    : sending_(false),
+      exportRequested_(false),
+      format_(LogFormat::Nmea),
+      fixSecond_(0),
+      haveRmc_(false),
+      haveGga_(false),
+      haveLogged_(false),
+      lastLogged_(0),
+      intervalS_(intervalS),
+      records_(0),
+      lastBytesIn_(0),
+      lastRxMs_(0) {}
+
+bool FixLogger::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<FixLogger*>(ctx)->apply(p, raw);
+}
+
+bool FixLogger::apply(const NmeaParser& p, SentenceView&) {
+  if (p.type() == SentenceType::Proprietary) {
+    if (!p.field(0).equals("PVX8L")) return true;
+    requestExport(p.fieldCount() > 1 && p.field(1).equals("GPX")
+                      ? LogFormat::Gpx
+                      : LogFormat::Nmea);
+    return false;
+  }
+  if (p.type() == SentenceType::RMC) {
+    RmcData r;
+    // Month 0: no date to give the record a time.
+    if (!decodeRmc(p, r) || !r.valid || !r.hasPosition || r.date.month == 0) {
+      return true;
+    }
+    start(r.time.secondOfDay());
+    fix_.time = logTime(r.date, r.time);
+    fix_.latitude = r.latitude;
+    fix_.longitude = r.longitude;
+    fix_.speed = r.speed;
+    fix_.course = r.course;
+    haveRmc_ = true;
+  } else if (p.type() == SentenceType::GGA) {
+    GgaData g;
+    if (!decodeGga(p, g) || g.quality == 0 || !g.hasPosition) return true;
+    start(g.time.secondOfDay());
+    fix_.satellites = g.satellites;
+    fix_.hdop = g.hdop;
+    haveGga_ = true;
+  } else {
+    return true;
+  }
+  if (haveRmc_ && haveGga_) commit();
+  return true;
+}
+
+// Begins collecting `second`, first logging the previous epoch if it had no
+// GGA.
+void FixLogger::start(uint32_t second) {
+  if ((haveRmc_ || haveGga_) && second == fixSecond_) return;
+  commit();
+  fixSecond_ = second;
+  fix_.satellites = 0;
+  fix_.hdop = kNoValue16;
+}
+
+void FixLogger::commit() {
+  if (haveRmc_ && (!haveLogged_ || fix_.time - lastLogged_ >= intervalS_) &&
+      log_.append(fix_)) {
+    ++records_;
+    lastLogged_ = fix_.time;
+    haveLogged_ = true;
+  }
+  haveRmc_ = false;
+  haveGga_ = false;
+}
+
+void FixLogger::flush() {
+  commit();
+  log_.flush();
+}
+
+void FixLogger::requestExport(LogFormat format) {
+  if (!log_.enabled()) return;
+  format_ = format;
+  exportRequested_ = true;
+}
+
+void FixLogger::update(uint32_t nowMs, Bridge& bridge) {
+  const uint32_t in = bridge.stats().bytesIn;
+  if (in != lastBytesIn_) {
+    lastBytesIn_ = in;
+    lastRxMs_ = nowMs;
+  }
+  const bool gap = !bridge.txPending() && !bridge.parser().inSentence() &&
+                   nowMs - lastRxMs_ >= kQuietMs;
+  // An SD card holds up the main loop while it writes; keep that out of
+  // the bursts.
+  if (gap) log_.update();
+  if (sending_) {
+    if (bridge.injectPending()) return;
+    sending_ = false;
+  }
+  if (exportRequested_) {
+    // Include the records still in RAM; update() writes them first.
+    log_.flush();
+    if (!log_.flushed()) return;
+    exportRequested_ = false;
+    export_.begin(format_);
+  }
+  if (!export_.active() || !gap) return;
+  const uint8_t n = export_.next(log_, line_);
+  if (n && bridge.injectBuffer(reinterpret_cast<const uint8_t*>(line_), n)) {
+    sending_ = true;
+  }
+}
+
+}  // namespace vx8
@@ -0,0 +1,96 @@
+// Track logging on the device: the fix log (fix_log.h) as a filter stage.
+//
+// Every epoch with a valid RMC becomes one FixRecord, at most one per
+// `intervalS` seconds; the GGA of the same second adds satellites and HDOP.
+// The stage never drops fixes, and the only work on the forwarding path is
+// decoding and packing 20 bytes. Writes happen in update(), a page at a
+// time, and only in the gaps between bursts: an SD card holds up the main
+// loop until it has written the page.
+//
+// A $PVX8L sentence on the GPS-side UART (or requestExport()) streams the
+// log out on the radio-side TX line, oldest record first: $PVX8L for NMEA
+// (RMC + GGA per record), $PVX8L,GPX for a GPX track. Lines are injected
+// only while the TX line is idle and the GPS has been quiet for a moment,
+// i.e. in the gaps between bursts, so a burst is delayed by at most the one
+// line already going out. At 9600 baud and 1 Hz that is about 4.6 records a
+// second between GPS-only epochs and 2.5 between multi-GNSS ones. Disconnect
+// the radio first if it should not see the replayed NMEA. Logging carries
+// on during an export.
+//
+// Place it right after the monitor: the output profile drops the query. So
+// it logs the module's fixes as they arrive, not what the radio gets: the
+// position jitter the motion filter holds back while stationary is in the
+// log.
+
+#ifndef VX8_FIX_LOGGER_H
+#define VX8_FIX_LOGGER_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "fix_log.h"
+#include "log_export.h"
+#include "nmea_parser.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+class FixLogger {
+ public:
+  // GPS silence before an export line may go out.
+  static const uint8_t kQuietMs = 20;
+
+  explicit FixLogger(uint8_t intervalS = VX8_LOG_INTERVAL_S);
+
+  // See FixLog::begin().
+  bool begin(const LogDevice& device) { return log_.begin(device); }
+
+  // Filter stage: records fixes, swallows export requests.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  // Main loop, after Bridge::poll(): writes to the device and injects the
+  // next export line when there is a gap.
+  void update(uint32_t nowMs, Bridge& bridge);
+
+  // Logs the epoch being collected and has update() write every record
+  // still in RAM, e.g. before shutting down; log().flushed() tells when.
+  void flush();
+
+  void requestExport(LogFormat format);
+  bool exporting() const {
+    return exportRequested_ || export_.active() || sending_;
+  }
+
+  // Records handed to the log.
+  uint32_t records() const { return records_; }
+  const FixLog& log() const { return log_; }
+
+ private:
+  void start(uint32_t second);
+  void commit();
+
+  FixLog log_;
+  LogExport export_;
+  char line_[LogExport::kMaxLine];
+  bool sending_;  // line_ is being injected
+  bool exportRequested_;
+  LogFormat format_;
+
+  FixRecord fix_;
+  uint32_t fixSecond_;  // UTC second of day of fix_
+  bool haveRmc_;
+  bool haveGga_;
+  bool haveLogged_;
+  uint32_t lastLogged_;  // FixRecord::time
+  uint8_t intervalS_;
+  uint32_t records_;
+
+  uint32_t lastBytesIn_;
+  uint32_t lastRxMs_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_FIX_LOGGER_H
@@ -0,0 +1,146 @@
+#include "fixed_math.h"
+
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+namespace {
+
+// cos(d degrees) * 32767 for d = 0..90.
+const uint16_t kCosTable[91] VX8_PROGMEM = {
+    32767, 32762, 32747, 32722, 32687, 32642, 32587, 32523, 32448, 32364,
+    32269, 32165, 32051, 31927, 31794, 31650, 31498, 31335, 31163, 30982,
+    30791, 30591, 30381, 30162, 29934, 29697, 29451, 29196, 28932, 28659,
+    28377, 28087, 27788, 27481, 27165, 26841, 26509, 26169, 25821, 25465,
+    25101, 24730, 24351, 23964, 23571, 23170, 22762, 22347, 21925, 21497,
+    21062, 20621, 20173, 19720, 19260, 18794, 18323, 17846, 17364, 16876,
+    16384, 15886, 15383, 14876, 14364, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126, 9580,  9032,  8481,  7927,  7371,  6813,  6252,
+    5690,  5126,  4560,  3993,  3425,  2856,  2286,  1715,  1144,  572,
+    0,
+};
+
+// Decimetres per micro-degree of arc on the mean-radius sphere
+// (6,371,008.8 m), in Q15: 1.1119508 * 32768.
+const uint16_t kDecimetresPerMicrodegreeQ15 = 36436;
+
+const int32_t kHalfTurn = 180L * kMicrodegreesPerDegree;
+
+// a * k / 32768 for a < 2^31 without a 64-bit intermediate.
+uint32_t mulQ15(uint32_t a, uint16_t k) {
+  return (a >> 15) * k + (((a & 0x7FFFU) * k + 0x4000U) >> 15);
+}
+
+uint32_t absDiff(int32_t a, int32_t b) {
+  return a > b ? static_cast<uint32_t>(a - b) : static_cast<uint32_t>(b - a);
+}
+
+}  // namespace
+
+int32_t nmeaToMicrodegrees(int32_t nmeaAngle) {
+  return nmeaAngle >= 0 ? (nmeaAngle + 3) / 6 : -((-nmeaAngle + 3) / 6);
+}
+
+int32_t microdegreesToNmea(int32_t microdegrees) { return microdegrees * 6; }
+
+uint8_t formatNmeaAngle(int32_t nmeaAngle, uint8_t degreeDigits,
+                        uint8_t decimals, char* out) {
+  uint32_t v = static_cast<uint32_t>(nmeaAngle < 0 ? -nmeaAngle : nmeaAngle);
+  // Round away the minute decimals that are not printed.
+  uint32_t unit = 1;
+  for (uint8_t i = decimals; i < 5; ++i) unit *= 10;
+  v = (v + unit / 2) / unit;
+
+  uint32_t perMinute = 1;
+  for (uint8_t i = 0; i < decimals; ++i) perMinute *= 10;
+  const uint32_t perDegree = 60 * perMinute;
+  const uint32_t degrees = v / perDegree;
+  const uint32_t minutes = (v % perDegree) / perMinute;
+  uint32_t frac = v % perMinute;
+
+  uint8_t n = 0;
+  uint32_t scale = 1;
+  for (uint8_t i = 1; i < degreeDigits; ++i) scale *= 10;
+  for (; scale > 0; scale /= 10) {
+    out[n++] = static_cast<char>('0' + (degrees / scale) % 10);
+  }
+  out[n++] = static_cast<char>('0' + minutes / 10);
+  out[n++] = static_cast<char>('0' + minutes % 10);
+  if (decimals > 0) {
+    out[n++] = '.';
+    for (uint8_t i = decimals; i > 0; --i) {
+      out[n + i - 1] = static_cast<char>('0' + frac % 10);
+      frac /= 10;
+    }
+    n = static_cast<uint8_t>(n + decimals);
+  }
+  return n;
+}
+
+uint32_t centiKnotsToCentiKmh(uint32_t centiKnots) {
+  return (centiKnots * 1852U + 500) / 1000;
+}
+
+uint32_t centiKmhToCentiKnots(uint32_t centiKmh) {
+  return (centiKmh * 1000U + 926) / 1852;
+}
+
+uint32_t centiKnotsToCmPerSecond(uint32_t centiKnots) {
+  // 1 knot = 1852 m / 3600 s.
+  return (centiKnots * 1852U + 1800) / 3600;
+}
+
+uint32_t cmPerSecondToCentiKnots(uint32_t cmPerSecond) {
+  return (cmPerSecond * 3600U + 926) / 1852;
+}
+
+uint16_t cosQ15(int32_t microdegrees) {
+  const uint32_t a = static_cast<uint32_t>(
+      microdegrees < 0 ? -microdegrees : microdegrees);
+  const uint32_t degrees = a / kMicrodegreesPerDegree;
+  if (degrees >= 90) return 0;
+  const uint32_t frac = a % kMicrodegreesPerDegree;
+  const uint16_t c0 = VX8_READ_U16(&kCosTable[degrees]);
+  const uint16_t c1 = VX8_READ_U16(&kCosTable[degrees + 1]);
+  const uint32_t drop =
+      ((c0 - c1) * frac + kMicrodegreesPerDegree / 2) / kMicrodegreesPerDegree;
+  return static_cast<uint16_t>(c0 - drop);
+}
+
+uint16_t isqrt32(uint32_t v) {
+  uint32_t root = 0;
+  uint32_t bit = static_cast<uint32_t>(1) << 30;
+  while (bit > v) bit >>= 2;
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return static_cast<uint16_t>(root);
+}
+
+uint32_t distanceDecimetres(int32_t lat1, int32_t lon1, int32_t lat2,
+                            int32_t lon2) {
+  uint32_t dLon = absDiff(lon1, lon2);
+  if (dLon > static_cast<uint32_t>(kHalfTurn)) {
+    dLon = 2 * static_cast<uint32_t>(kHalfTurn) - dLon;
+  }
+  const int32_t meanLat = lat1 / 2 + lat2 / 2;
+  const uint32_t dy = mulQ15(absDiff(lat1, lat2), kDecimetresPerMicrodegreeQ15);
+  const uint32_t dx = mulQ15(mulQ15(dLon, cosQ15(meanLat)),
+                             kDecimetresPerMicrodegreeQ15);
+
+  // Scale both legs down until their squares sum without overflowing.
+  const uint32_t longest = dx > dy ? dx : dy;
+  uint8_t shift = 0;
+  while ((longest >> shift) > 0xB504U) ++shift;
+  const uint32_t x = dx >> shift;
+  const uint32_t y = dy >> shift;
+  return static_cast<uint32_t>(isqrt32(x * x + y * y)) << shift;
+}
+
+}  // namespace vx8
@@ -0,0 +1,57 @@
+// Integer replacements for the float math a GPS bridge would otherwise need.
+//
+// On AVR every float operation is a soft-float library call, and sin/cos/sqrt
+// pull in kilobytes of flash. Everything here uses 32-bit integers only (no
+// 64-bit intermediates either) with these units:
+//   micro-degrees  int32, 1e-6 degree (~0.11 m of latitude)
+//   NMEA angle     int32, 1e-5 arc-minute, as decoded by nmea_sentences.h
+//   centi-knots    speed as decoded from RMC
+//   decimetres     distances
+// Accuracy is checked against double precision in tests/test_fixed_math.cpp.
+
+#ifndef VX8_FIXED_MATH_H
+#define VX8_FIXED_MATH_H
+
+#include <stdint.h>
+
+namespace vx8 {
+
+const int32_t kMicrodegreesPerDegree = 1000000L;
+
+// 1e-5 arc-minutes <-> micro-degrees. One NMEA unit is 1/6 micro-degree, so
+// the conversion to micro-degrees rounds to nearest.
+int32_t nmeaToMicrodegrees(int32_t nmeaAngle);
+int32_t microdegreesToNmea(int32_t microdegrees);
+
+// Writes |nmeaAngle| as NMEA text: `degreeDigits` zero-padded degree digits
+// (2 for latitude, 3 for longitude), two minute digits, '.', and `decimals`
+// (0-5) minute decimals, rounded. Returns the number of characters written;
+// the caller supplies the hemisphere from the sign. `out` is not terminated.
+uint8_t formatNmeaAngle(int32_t nmeaAngle, uint8_t degreeDigits,
+                        uint8_t decimals, char* out);
+
+// Speed conversions, rounded to nearest. Inputs up to 65535 centi-knots
+// (655 kn) and the equivalent in the other units.
+uint32_t centiKnotsToCentiKmh(uint32_t centiKnots);
+uint32_t centiKmhToCentiKnots(uint32_t centiKmh);
+uint32_t centiKnotsToCmPerSecond(uint32_t centiKnots);
+uint32_t cmPerSecondToCentiKnots(uint32_t cmPerSecond);
+
+// cos(latitude) in Q15 (32767 = 1.0) from a 1-degree table with linear
+// interpolation; absolute error below 1e-4.
+uint16_t cosQ15(int32_t microdegrees);
+
+// floor(sqrt(v)).
+uint16_t isqrt32(uint32_t v);
+
+// Equirectangular ("flat earth") distance between two points in
+// micro-degrees, in decimetres. Within 0.1% (or 1 dm for very short hops) of
+// the same formula evaluated in double precision, and of the great-circle
+// distance for the short hops a moving GPS sees between fixes. Handles the
+// antimeridian.
+uint32_t distanceDecimetres(int32_t lat1, int32_t lon1, int32_t lat2,
+                            int32_t lon2);
+
+}  // namespace vx8
+
+#endif  // VX8_FIXED_MATH_H
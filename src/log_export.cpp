@@ -0,0 +1,220 @@
+#include "log_export.h"
+
+#include "fixed_math.h"
+#include "nmea_parser.h"
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+namespace {
+
+const char kGpxHeader0[] VX8_PROGMEM =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+const char kGpxHeader1[] VX8_PROGMEM =
+    "<gpx version=\"1.1\" creator=\"vx8gps\" "
+    "xmlns=\"http://www.topografix.com/GPX/1/1\">";
+const char kGpxHeader2[] VX8_PROGMEM = "<trk><trkseg>";
+const char kGpxFooter0[] VX8_PROGMEM = "</trkseg></trk>";
+const char kGpxFooter1[] VX8_PROGMEM = "</gpx>";
+
+const char* const kGpxHeader[] = {kGpxHeader0, kGpxHeader1, kGpxHeader2};
+const char* const kGpxFooter[] = {kGpxFooter0, kGpxFooter1};
+
+// Copies a string from flash; returns the new length.
+uint8_t putFlash(char* out, uint8_t n, const char* flashText) {
+  for (char c; (c = static_cast<char>(VX8_READ_U8(flashText))) != 0;
+       ++flashText) {
+    out[n++] = c;
+  }
+  return n;
+}
+
+uint8_t putChar(char* out, uint8_t n, char c) {
+  out[n++] = c;
+  return n;
+}
+
+uint8_t putText(char* out, uint8_t n, const char* text) {
+  while (*text) out[n++] = *text++;
+  return n;
+}
+
+uint8_t putUnsigned(char* out, uint8_t n, uint32_t v) {
+  return static_cast<uint8_t>(n + formatUnsigned(v, out + n));
+}
+
+uint8_t putDigits(char* out, uint8_t n, uint32_t v, uint8_t digits) {
+  for (uint8_t i = digits; i > 0; --i) {
+    out[n + i - 1] = static_cast<char>('0' + v % 10);
+    v /= 10;
+  }
+  return static_cast<uint8_t>(n + digits);
+}
+
+// Hundredths as "x.xx".
+uint8_t putHundredths(char* out, uint8_t n, uint16_t v) {
+  n = putUnsigned(out, n, v / 100U);
+  n = putChar(out, n, '.');
+  return putDigits(out, n, v % 100U, 2);
+}
+
+uint8_t putTime(char* out, uint8_t n, const UtcTime& t) {
+  n = putDigits(out, n, t.hour, 2);
+  n = putDigits(out, n, t.minute, 2);
+  n = putDigits(out, n, t.second, 2);
+  return putText(out, n, ".00");
+}
+
+uint8_t putAngle(char* out, uint8_t n, int32_t angle, bool latitude) {
+  n = static_cast<uint8_t>(
+      n + formatNmeaAngle(angle, latitude ? 2 : 3, 5, out + n));
+  n = putChar(out, n, ',');
+  return putChar(out, n, latitude ? (angle < 0 ? 'S' : 'N')
+                                  : (angle < 0 ? 'W' : 'E'));
+}
+
+// Signed degrees with six decimals.
+uint8_t putDegrees(char* out, uint8_t n, int32_t nmeaAngle) {
+  int32_t v = nmeaToMicrodegrees(nmeaAngle);
+  if (v < 0) {
+    n = putChar(out, n, '-');
+    v = -v;
+  }
+  const uint32_t u = static_cast<uint32_t>(v);
+  n = putUnsigned(out, n, u / kMicrodegreesPerDegree);
+  n = putChar(out, n, '.');
+  return putDigits(out, n, u % kMicrodegreesPerDegree, 6);
+}
+
+uint8_t endLine(char* out, uint8_t n) {
+  n = putChar(out, n, '\r');
+  return putChar(out, n, '\n');
+}
+
+}  // namespace
+
+LogExport::LogExport()
+    : format_(LogFormat::Nmea),
+      state_(State::Done),
+      line_(0),
+      secondHalf_(false) {
+  cursor_.started = false;
+}
+
+void LogExport::begin(LogFormat format) {
+  format_ = format;
+  state_ = format == LogFormat::Gpx ? State::Header : State::Records;
+  line_ = 0;
+  secondHalf_ = false;
+  cursor_.started = false;
+}
+
+uint8_t LogExport::next(const FixLog& log, char* out) {
+  switch (state_) {
+    case State::Header: {
+      const uint8_t n = endLine(out, putFlash(out, 0, kGpxHeader[line_]));
+      if (++line_ == sizeof(kGpxHeader) / sizeof(kGpxHeader[0])) {
+        state_ = State::Records;
+      }
+      return n;
+    }
+    case State::Records:
+      if (secondHalf_) {
+        secondHalf_ = false;
+        return formatGga(record_, out);
+      }
+      if (!log.ready()) return 0;
+      if (log.next(cursor_, record_)) {
+        if (format_ == LogFormat::Gpx) return formatTrackPoint(record_, out);
+        secondHalf_ = true;
+        return formatRmc(record_, out);
+      }
+      line_ = 0;
+      state_ = format_ == LogFormat::Gpx ? State::Footer : State::Done;
+      return format_ == LogFormat::Gpx ? next(log, out) : 0;
+    case State::Footer: {
+      const uint8_t n = endLine(out, putFlash(out, 0, kGpxFooter[line_]));
+      if (++line_ == sizeof(kGpxFooter) / sizeof(kGpxFooter[0])) {
+        state_ = State::Done;
+      }
+      return n;
+    }
+    case State::Done:
+      break;
+  }
+  return 0;
+}
+
+uint8_t LogExport::formatRmc(const FixRecord& r, char* out) {
+  UtcDate d;
+  UtcTime t;
+  splitLogTime(r.time, d, t);
+  uint8_t n = putText(out, 0, "$GPRMC,");
+  n = putTime(out, n, t);
+  n = putText(out, n, ",A,");
+  n = putAngle(out, n, r.latitude, true);
+  n = putChar(out, n, ',');
+  n = putAngle(out, n, r.longitude, false);
+  n = putChar(out, n, ',');
+  n = putHundredths(out, n, r.speed);
+  n = putChar(out, n, ',');
+  if (r.course != kNoValue16) n = putHundredths(out, n, r.course);
+  n = putChar(out, n, ',');
+  n = putDigits(out, n, d.day, 2);
+  n = putDigits(out, n, d.month, 2);
+  n = putDigits(out, n, d.year, 2);
+  n = putText(out, n, ",,,A");
+  return finishSentence(out, n);
+}
+
+uint8_t LogExport::formatGga(const FixRecord& r, char* out) {
+  UtcDate d;
+  UtcTime t;
+  splitLogTime(r.time, d, t);
+  uint8_t n = putText(out, 0, "$GPGGA,");
+  n = putTime(out, n, t);
+  n = putChar(out, n, ',');
+  n = putAngle(out, n, r.latitude, true);
+  n = putChar(out, n, ',');
+  n = putAngle(out, n, r.longitude, false);
+  n = putText(out, n, ",1,");
+  n = putDigits(out, n, r.satellites, 2);
+  n = putChar(out, n, ',');
+  if (r.hdop != kNoValue16) n = putHundredths(out, n, r.hdop);
+  n = putText(out, n, ",,M,,M,,");
+  return finishSentence(out, n);
+}
+
+uint8_t LogExport::formatTrackPoint(const FixRecord& r, char* out) {
+  UtcDate d;
+  UtcTime t;
+  splitLogTime(r.time, d, t);
+  uint8_t n = putText(out, 0, "<trkpt lat=\"");
+  n = putDegrees(out, n, r.latitude);
+  n = putText(out, n, "\" lon=\"");
+  n = putDegrees(out, n, r.longitude);
+  n = putText(out, n, "\"><time>20");
+  n = putDigits(out, n, d.year, 2);
+  n = putChar(out, n, '-');
+  n = putDigits(out, n, d.month, 2);
+  n = putChar(out, n, '-');
+  n = putDigits(out, n, d.day, 2);
+  n = putChar(out, n, 'T');
+  n = putDigits(out, n, t.hour, 2);
+  n = putChar(out, n, ':');
+  n = putDigits(out, n, t.minute, 2);
+  n = putChar(out, n, ':');
+  n = putDigits(out, n, t.second, 2);
+  n = putText(out, n, "Z</time><sat>");
+  n = putUnsigned(out, n, r.satellites);
+  n = putText(out, n, "</sat>");
+  if (r.hdop != kNoValue16) {
+    n = putText(out, n, "<hdop>");
+    n = putHundredths(out, n, r.hdop);
+    n = putText(out, n, "</hdop>");
+  }
+  n = putText(out, n, "</trkpt>");
+  return endLine(out, n);
+}
+
+}  // namespace vx8
@@ -0,0 +1,53 @@
+// Reads the fix log back out as text, one line at a time: on the device
+// for streaming it over the serial line (fix_logger.h), and on the host in
+// tools/vx8_logdump.cpp.
+//   Nmea  $GPRMC and $GPGGA per record. Altitude and fix quality are not
+//         logged, so GGA reports quality 1 and no altitude.
+//   Gpx   a GPX 1.1 track with one <trkpt> per record: position in degrees
+//         to 1e-6, time, satellites and HDOP.
+// Lines end in CR LF and are at most kMaxLine characters.
+
+#ifndef VX8_LOG_EXPORT_H
+#define VX8_LOG_EXPORT_H
+
+#include <stdint.h>
+
+#include "fix_log.h"
+
+namespace vx8 {
+
+enum class LogFormat : uint8_t { Nmea, Gpx };
+
+class LogExport {
+ public:
+  static const uint8_t kMaxLine = 128;
+
+  LogExport();
+
+  // Starts again from the oldest record.
+  void begin(LogFormat format);
+  bool active() const { return state_ != State::Done; }
+
+  // Writes the next line to `out` and returns its length, or 0 if there is
+  // none right now: the device is busy, or the export is finished
+  // (active() turns false).
+  uint8_t next(const FixLog& log, char* out);
+
+  static uint8_t formatRmc(const FixRecord& r, char* out);
+  static uint8_t formatGga(const FixRecord& r, char* out);
+  static uint8_t formatTrackPoint(const FixRecord& r, char* out);
+
+ private:
+  enum class State : uint8_t { Header, Records, Footer, Done };
+
+  LogFormat format_;
+  State state_;
+  uint8_t line_;  // within the header or footer
+  bool secondHalf_;  // GGA of the current record still to come
+  FixRecord record_;
+  LogCursor cursor_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_LOG_EXPORT_H
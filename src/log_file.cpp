@@ -0,0 +1,68 @@
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "log_media.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace vx8 {
+
+namespace {
+
+struct LogFile {
+  int fd;
+  uint16_t pagesPerBlock;
+};
+
+// One file at a time, like the one chip on a board.
+LogFile g_file;
+
+bool fileRead(void* ctx, uint32_t page, uint8_t offset, uint8_t* data,
+              uint16_t len) {
+  const LogFile& f = *static_cast<LogFile*>(ctx);
+  const off_t at = off_t(page) * FixLog::kPageSize + offset;
+  const ssize_t n = pread(f.fd, data, len, at);
+  if (n < 0) return false;
+  memset(data + n, 0xFF, len - size_t(n));
+  return true;
+}
+
+bool fileProgram(void* ctx, uint32_t page, const uint8_t* data) {
+  const LogFile& f = *static_cast<LogFile*>(ctx);
+  const off_t at = off_t(page) * FixLog::kPageSize;
+  return pwrite(f.fd, data, FixLog::kPageSize, at) == FixLog::kPageSize;
+}
+
+bool fileErase(void* ctx, uint32_t block) {
+  const LogFile& f = *static_cast<LogFile*>(ctx);
+  uint8_t blank[FixLog::kPageSize];
+  memset(blank, 0xFF, sizeof(blank));
+  const uint32_t first = block * f.pagesPerBlock;
+  for (uint32_t p = first; p < first + f.pagesPerBlock; ++p) {
+    if (!fileProgram(ctx, p, blank)) return false;
+  }
+  return true;
+}
+
+bool fileBusy(void*) { return false; }
+
+}  // namespace
+
+LogDevice fileLog(int fd, uint32_t pages, uint16_t pagesPerBlock) {
+  g_file.fd = fd;
+  g_file.pagesPerBlock = pagesPerBlock;
+  LogDevice d;
+  d.read = &fileRead;
+  d.program = &fileProgram;
+  d.erase = &fileErase;
+  d.busy = &fileBusy;
+  d.ctx = &g_file;
+  d.pages = fd >= 0 ? pages : 0;
+  d.pagesPerBlock = pagesPerBlock;
+  return d;
+}
+
+}  // namespace vx8
+
+#endif  // __linux__ && !ARDUINO
@@ -0,0 +1,34 @@
+// Media for the fix log (fix_log.h). Each returns a device with no pages if
+// the medium does not answer, which leaves the log disabled.
+//   log_spi_flash.cpp  SPI NOR flash (W25Q, AT25SF, MX25 and the like, up
+//                      to 16 MiB): 256-byte pages, 4 KiB sector erase
+//   log_sd.cpp         SD card (VX8_LOG_SD): VX8LOG.BIN, VX8_LOG_SD_PAGES
+//                      pages long; the card does its own wear levelling
+//   log_file.cpp       Linux: a file or a flash image (board_linux.h,
+//                      tools/vx8_logdump.cpp)
+
+#ifndef VX8_LOG_MEDIA_H
+#define VX8_LOG_MEDIA_H
+
+#include <stdint.h>
+
+#include "fix_log.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+#if defined(ARDUINO)
+#if VX8_LOG_SD
+LogDevice sdCardLog(uint8_t csPin);
+#else
+LogDevice spiFlashLog(uint8_t csPin);
+#endif
+#elif defined(__linux__)
+// `pages` of the file starting at offset 0, erased `pagesPerBlock` at a
+// time like NOR flash. Reading past the end of the file gives 0xFF.
+LogDevice fileLog(int fd, uint32_t pages, uint16_t pagesPerBlock);
+#endif
+
+}  // namespace vx8
+
+#endif  // VX8_LOG_MEDIA_H
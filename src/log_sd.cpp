@@ -0,0 +1,87 @@
+#include "vx8_config.h"
+
+#if defined(ARDUINO) && VX8_FIX_LOG && VX8_LOG_SD
+
+#if !defined(__AVR__) && !defined(ARDUINO_ARCH_SAMD) && \
+    !defined(ARDUINO_ARCH_ESP32)
+#error "VX8_LOG_SD needs the AVR, SAMD or ESP32 SD library; use SPI flash"
+#endif
+
+#include "log_media.h"
+
+#include <Arduino.h>
+#include <SD.h>
+#include <string.h>
+
+namespace vx8 {
+
+namespace {
+
+#if defined(ARDUINO_ARCH_ESP32)
+// The ESP32 core's SD is a VFS over FatFs: paths start at the root, modes
+// are fopen()'s, and "r+" only opens a file that already exists.
+const char kLogFile[] = "/VX8LOG.BIN";
+
+File openLog() {
+  if (!SD.exists(kLogFile)) {
+    File created = SD.open(kLogFile, "w");
+    if (!created) return created;
+    created.close();
+  }
+  return SD.open(kLogFile, "r+");
+}
+#else
+const char kLogFile[] = "VX8LOG.BIN";
+
+// Not FILE_WRITE, which appends: pages are written in place.
+File openLog() { return SD.open(kLogFile, O_READ | O_WRITE | O_CREAT); }
+#endif
+
+File g_file;
+
+bool sdRead(void*, uint32_t page, uint8_t offset, uint8_t* data,
+            uint16_t len) {
+  const uint32_t at = page * FixLog::kPageSize + offset;
+  int n = 0;
+  if (at < g_file.size()) {
+    if (!g_file.seek(at)) return false;
+    // int on AVR and SAMD (-1 on error), size_t on ESP32.
+    n = static_cast<int>(g_file.read(data, len));
+    if (n < 0) return false;
+  }
+  memset(data + n, 0xFF, len - n);  // not written yet
+  return true;
+}
+
+bool sdProgram(void*, uint32_t page, const uint8_t* data) {
+  if (!g_file.seek(page * FixLog::kPageSize)) return false;
+  const size_t n = g_file.write(data, FixLog::kPageSize);
+  g_file.flush();
+  return n == FixLog::kPageSize;
+}
+
+// Pages are simply overwritten.
+bool sdErase(void*, uint32_t) { return true; }
+
+// The SD library waits for the card inside write() and flush(), so there is
+// nothing left to wait for; FixLogger keeps that stall between bursts.
+bool sdBusy(void*) { return false; }
+
+}  // namespace
+
+LogDevice sdCardLog(uint8_t csPin) {
+  LogDevice d;
+  d.read = &sdRead;
+  d.program = &sdProgram;
+  d.erase = &sdErase;
+  d.busy = &sdBusy;
+  d.ctx = 0;
+  d.pages = 0;
+  d.pagesPerBlock = 1;
+  if (SD.begin(csPin) && (g_file = openLog())) d.pages = VX8_LOG_SD_PAGES;
+  return d;
+}
+
+}  // namespace vx8
+
+#endif  // ARDUINO && VX8_FIX_LOG && VX8_LOG_SD
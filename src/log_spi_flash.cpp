@@ -0,0 +1,123 @@
+#include "vx8_config.h"
+
+// Only with the log on, so that other builds do not pull in SPI.
+#if defined(ARDUINO) && VX8_FIX_LOG && !VX8_LOG_SD
+
+#include "log_media.h"
+
+#include <Arduino.h>
+#include <SPI.h>
+
+namespace vx8 {
+
+namespace {
+
+const uint8_t kRead = 0x03;
+const uint8_t kPageProgram = 0x02;
+const uint8_t kSectorErase = 0x20;  // 4 KiB
+const uint8_t kWriteEnable = 0x06;
+const uint8_t kReadStatus = 0x05;
+const uint8_t kJedecId = 0x9F;
+const uint8_t kStatusBusy = 0x01;
+const uint16_t kPagesPerSector = 4096 / FixLog::kPageSize;
+
+struct Chip {
+  uint8_t cs;
+};
+
+Chip g_chip;
+
+void select(const Chip& c) {
+  SPI.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+  digitalWrite(c.cs, LOW);
+}
+
+void deselect(const Chip& c) {
+  digitalWrite(c.cs, HIGH);
+  SPI.endTransaction();
+}
+
+void command(const Chip& c, uint8_t op) {
+  select(c);
+  SPI.transfer(op);
+  deselect(c);
+}
+
+// Starts `op` on a 24-bit address; the caller deselects.
+void addressed(const Chip& c, uint8_t op, uint32_t address) {
+  select(c);
+  SPI.transfer(op);
+  SPI.transfer(static_cast<uint8_t>(address >> 16));
+  SPI.transfer(static_cast<uint8_t>(address >> 8));
+  SPI.transfer(static_cast<uint8_t>(address));
+}
+
+bool flashRead(void* ctx, uint32_t page, uint8_t offset, uint8_t* data,
+               uint16_t len) {
+  const Chip& c = *static_cast<Chip*>(ctx);
+  addressed(c, kRead, page * FixLog::kPageSize + offset);
+  for (uint16_t i = 0; i < len; ++i) data[i] = SPI.transfer(0);
+  deselect(c);
+  return true;
+}
+
+bool flashProgram(void* ctx, uint32_t page, const uint8_t* data) {
+  const Chip& c = *static_cast<Chip*>(ctx);
+  command(c, kWriteEnable);
+  addressed(c, kPageProgram, page * FixLog::kPageSize);
+  for (uint16_t i = 0; i < FixLog::kPageSize; ++i) SPI.transfer(data[i]);
+  deselect(c);
+  return true;
+}
+
+bool flashErase(void* ctx, uint32_t block) {
+  const Chip& c = *static_cast<Chip*>(ctx);
+  command(c, kWriteEnable);
+  addressed(c, kSectorErase, block * kPagesPerSector * FixLog::kPageSize);
+  deselect(c);
+  return true;
+}
+
+bool flashBusy(void* ctx) {
+  const Chip& c = *static_cast<Chip*>(ctx);
+  select(c);
+  SPI.transfer(kReadStatus);
+  const uint8_t status = SPI.transfer(0);
+  deselect(c);
+  return status & kStatusBusy;
+}
+
+}  // namespace
+
+LogDevice spiFlashLog(uint8_t csPin) {
+  g_chip.cs = csPin;
+  pinMode(csPin, OUTPUT);
+  digitalWrite(csPin, HIGH);
+  SPI.begin();
+
+  // The third JEDEC ID byte is log2 of the size in bytes on nearly every
+  // part; 64 KiB to 16 MiB fit 24-bit addressing.
+  select(g_chip);
+  SPI.transfer(kJedecId);
+  const uint8_t maker = SPI.transfer(0);
+  SPI.transfer(0);
+  const uint8_t sizeLog2 = SPI.transfer(0);
+  deselect(g_chip);
+
+  LogDevice d;
+  d.read = &flashRead;
+  d.program = &flashProgram;
+  d.erase = &flashErase;
+  d.busy = &flashBusy;
+  d.ctx = &g_chip;
+  d.pages = 0;
+  d.pagesPerBlock = kPagesPerSector;
+  if (maker != 0x00 && maker != 0xFF && sizeLog2 >= 16 && sizeLog2 <= 24) {
+    d.pages = (1UL << sizeLog2) / FixLog::kPageSize;
+  }
+  return d;
+}
+
+}  // namespace vx8
+
+#endif  // ARDUINO && VX8_FIX_LOG && !VX8_LOG_SD
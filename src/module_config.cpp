@@ -0,0 +1,299 @@
+#include "module_config.h"
+
+#include "pmtk.h"
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+namespace {
+
+// Candidate module baud rates in hundreds, most common defaults first.
+const uint16_t kCandidateBauds[] VX8_PROGMEM = {96, 384, 1152, 576, 192, 48};
+const uint8_t kCandidateCount =
+    sizeof(kCandidateBauds) / sizeof(kCandidateBauds[0]);
+
+uint32_t candidateBaud(uint8_t i) {
+  return static_cast<uint32_t>(VX8_READ_U16(&kCandidateBauds[i])) * 100;
+}
+
+// Every standard NMEA message a u-blox can emit and the profile bit that
+// keeps it on; 0 means always off.
+struct UbxNmeaMessage {
+  uint8_t id;
+  uint8_t sentence;
+};
+
+const UbxNmeaMessage kUbxMessages[] = {
+    {ubx::kNmeaGga, VX8_SENTENCE_GGA}, {ubx::kNmeaGll, 0},
+    {ubx::kNmeaGsa, VX8_SENTENCE_GSA}, {ubx::kNmeaGsv, VX8_SENTENCE_GSV},
+    {ubx::kNmeaRmc, VX8_SENTENCE_RMC}, {ubx::kNmeaVtg, 0},
+    {ubx::kNmeaGrs, 0},                {ubx::kNmeaGst, 0},
+    {ubx::kNmeaZda, 0},                {ubx::kNmeaGbs, 0},
+    {ubx::kNmeaDtm, 0},                {ubx::kNmeaGns, 0},
+};
+const uint8_t kUbxMessageCount =
+    sizeof(kUbxMessages) / sizeof(kUbxMessages[0]);
+
+bool contains(const NmeaField& f, const char* needle) {
+  for (uint8_t i = 0; i < f.len; ++i) {
+    uint8_t j = 0;
+    while (needle[j] && i + j < f.len && f.data[i + j] == needle[j]) ++j;
+    if (!needle[j]) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+ModuleConfigOptions ModuleConfigOptions::defaults() {
+  ModuleConfigOptions o;
+  o.baud = VX8_GPS_BAUD;
+  o.fixIntervalMs = VX8_GPS_FIX_INTERVAL_MS;
+  o.sentences = VX8_PROFILE_SENTENCES;
+  return o;
+}
+
+ModuleConfigurator::ModuleConfigurator(const ConfigPort& port,
+                                       const ModuleConfigOptions& options)
+    : port_(port),
+      options_(options),
+      phase_(Phase::Done),
+      result_(Result::Pending),
+      module_(GpsModule::Unknown),
+      hint_(GpsModule::Unknown),
+      deadline_(0),
+      baud_(0),
+      candidate_(0),
+      step_(0),
+      attempts_(0),
+      failures_(0),
+      probedOther_(false),
+      sawTraffic_(false),
+      ack_(Ack::None),
+      expectClass_(0),
+      expectId_(0),
+      expectPmtk_(0) {}
+
+void ModuleConfigurator::begin(uint32_t nowMs) {
+  result_ = Result::Pending;
+  module_ = GpsModule::Unknown;
+  hint_ = GpsModule::Unknown;
+  failures_ = 0;
+  candidate_ = 0;
+  probedOther_ = false;
+  sawTraffic_ = false;
+  setBaud(candidateBaud(0));
+  enter(Phase::Detect, nowMs, kListenMs);
+}
+
+void ModuleConfigurator::onRxByte(uint8_t b) {
+  if (nmea_.feed(b) == NmeaParser::Status::Sentence) onSentence();
+
+  if (ubx_.feed(b) == ubx::Parser::Status::Frame) {
+    sawTraffic_ = true;
+    bool positive;
+    uint8_t cls, id;
+    if (ubx_.isAck(positive, cls, id) && cls == expectClass_ &&
+        id == expectId_ &&
+        (phase_ == Phase::ProbeUbx || phase_ == Phase::Configure)) {
+      ack_ = positive ? Ack::Positive : Ack::Negative;
+    }
+  }
+}
+
+void ModuleConfigurator::onSentence() {
+  sawTraffic_ = true;
+  if (phase_ == Phase::Detect) {
+    const NmeaField addr = nmea_.field(0);
+    if (addr.len == 5 && addr.data[2] == 'T' && addr.data[3] == 'X' &&
+        addr.data[4] == 'T' && contains(nmea_.field(4), "u-blox")) {
+      hint_ = GpsModule::Ublox;
+    } else if (addr.equals("PMTK011") || addr.equals("PMTK010")) {
+      hint_ = GpsModule::Mediatek;
+    }
+    return;
+  }
+  uint16_t command;
+  uint8_t flag;
+  if ((phase_ == Phase::ProbeMtk || phase_ == Phase::Configure) &&
+      pmtk::parseAck(nmea_, command, flag) && command == expectPmtk_) {
+    ack_ = flag == pmtk::kAckOk ? Ack::Positive : Ack::Negative;
+  }
+}
+
+ModuleConfigurator::Result ModuleConfigurator::poll(uint32_t nowMs) {
+  switch (phase_) {
+    case Phase::Detect:
+      if (sawTraffic_) {
+        baud_ = candidateBaud(candidate_);
+        startProbe(hint_ == GpsModule::Mediatek ? Phase::ProbeMtk
+                                                : Phase::ProbeUbx,
+                   nowMs);
+      } else if (expired(nowMs)) {
+        if (++candidate_ == kCandidateCount) {
+          setBaud(options_.baud);
+          finish(Result::NoSignal);
+        } else {
+          setBaud(candidateBaud(candidate_));
+          enter(Phase::Detect, nowMs, kListenMs);
+        }
+      }
+      break;
+
+    case Phase::ProbeUbx:
+    case Phase::ProbeMtk:
+      // Even a negative acknowledgement proves which protocol is spoken.
+      if (ack_ != Ack::None) {
+        module_ = phase_ == Phase::ProbeUbx ? GpsModule::Ublox
+                                            : GpsModule::Mediatek;
+        step_ = 0;
+        attempts_ = 0;
+        sendStep(nowMs);
+      } else if (expired(nowMs)) {
+        if (probedOther_) {
+          finish(Result::Unidentified);
+        } else {
+          probedOther_ = true;
+          startProbe(phase_ == Phase::ProbeUbx ? Phase::ProbeMtk
+                                               : Phase::ProbeUbx,
+                     nowMs);
+        }
+      }
+      break;
+
+    case Phase::Configure:
+      if (ack_ != Ack::None || expired(nowMs)) {
+        if (ack_ == Ack::None && ++attempts_ < kAttempts) {
+          sendStep(nowMs);
+          break;
+        }
+        if (ack_ != Ack::Positive) ++failures_;
+        ++step_;
+        attempts_ = 0;
+        sendStep(nowMs);
+      }
+      break;
+
+    case Phase::SwitchBaud:
+      // Give the command time to leave the UART before changing speed.
+      if (expired(nowMs)) {
+        setBaud(options_.baud);
+        sawTraffic_ = false;
+        enter(Phase::Verify, nowMs, kVerifyMs);
+      }
+      break;
+
+    case Phase::Verify:
+      if (sawTraffic_) {
+        baud_ = options_.baud;
+        finish(failures_ ? Result::Partial : Result::Configured);
+      } else if (expired(nowMs)) {
+        setBaud(baud_);
+        ++failures_;
+        finish(Result::Partial);
+      }
+      break;
+
+    case Phase::Done:
+      break;
+  }
+  return result_;
+}
+
+void ModuleConfigurator::enter(Phase phase, uint32_t nowMs,
+                               uint16_t timeoutMs) {
+  phase_ = phase;
+  deadline_ = nowMs + timeoutMs;
+  ack_ = Ack::None;
+}
+
+bool ModuleConfigurator::expired(uint32_t nowMs) const {
+  return static_cast<int32_t>(nowMs - deadline_) >= 0;
+}
+
+void ModuleConfigurator::startProbe(Phase probe, uint32_t nowMs) {
+  uint8_t buf[pmtk::kMaxSentence];
+  uint8_t len;
+  if (probe == Phase::ProbeUbx) {
+    expectClass_ = ubx::kClassCfg;
+    expectId_ = ubx::kIdCfgRate;
+    len = ubx::poll(ubx::kClassCfg, ubx::kIdCfgRate, buf);
+  } else {
+    expectPmtk_ = pmtk::kCmdTest;
+    len = pmtk::test(reinterpret_cast<char*>(buf));
+  }
+  send(buf, len);
+  enter(probe, nowMs, kAckMs);
+}
+
+void ModuleConfigurator::sendStep(uint32_t nowMs) {
+  uint8_t buf[pmtk::kMaxSentence];
+  const uint8_t len = buildStep(step_, buf);
+  if (len == 0) {
+    afterConfigure(nowMs);
+    return;
+  }
+  send(buf, len);
+  enter(Phase::Configure, nowMs, kAckMs);
+}
+
+void ModuleConfigurator::afterConfigure(uint32_t nowMs) {
+  if (baud_ == options_.baud) {
+    finish(failures_ ? Result::Partial : Result::Configured);
+    return;
+  }
+  uint8_t buf[pmtk::kMaxSentence];
+  const uint8_t len =
+      module_ == GpsModule::Ublox
+          ? ubx::cfgPrt(options_.baud, buf)
+          : pmtk::setBaud(options_.baud, reinterpret_cast<char*>(buf));
+  send(buf, len);
+  enter(Phase::SwitchBaud, nowMs, kDrainMs);
+}
+
+// Writes command `step` for the identified module and records the expected
+// acknowledgement. Returns 0 once every step has been sent.
+uint8_t ModuleConfigurator::buildStep(uint8_t step, uint8_t* out) {
+  if (module_ == GpsModule::Ublox) {
+    expectClass_ = ubx::kClassCfg;
+    if (step < kUbxMessageCount) {
+      expectId_ = ubx::kIdCfgMsg;
+      const UbxNmeaMessage& m = kUbxMessages[step];
+      const uint8_t rate = (m.sentence & options_.sentences) ? 1 : 0;
+      return ubx::cfgMsg(ubx::kClassNmea, m.id, rate, out);
+    }
+    if (step == kUbxMessageCount) {
+      expectId_ = ubx::kIdCfgRate;
+      return ubx::cfgRate(options_.fixIntervalMs, out);
+    }
+    return 0;
+  }
+  char* s = reinterpret_cast<char*>(out);
+  switch (step) {
+    case 0:
+      expectPmtk_ = pmtk::kCmdOutput;
+      return pmtk::setOutput(options_.sentences, s);
+    case 1:
+      expectPmtk_ = pmtk::kCmdFixInterval;
+      return pmtk::setFixInterval(options_.fixIntervalMs, s);
+    default:
+      return 0;
+  }
+}
+
+void ModuleConfigurator::send(const uint8_t* data, uint8_t len) {
+  port_.write(port_.ctx, data, len);
+}
+
+void ModuleConfigurator::setBaud(uint32_t baud) {
+  nmea_.reset();
+  ubx_.reset();
+  port_.setBaud(port_.ctx, baud);
+}
+
+void ModuleConfigurator::finish(Result result) {
+  phase_ = Phase::Done;
+  result_ = result;
+}
+
+}  // namespace vx8
@@ -0,0 +1,130 @@
+// Boot-time GPS module configuration.
+//
+// Rather than filtering 5-10 Hz multi-constellation output after the fact,
+// the bridge asks the module to send only what the VX-8R needs. The
+// configurator is a non-blocking state machine driven from setup()/loop():
+//
+//   1. Detect   listen at each candidate baud rate until a checksum-valid
+//               NMEA sentence (or UBX frame) shows up.
+//   2. Probe    identify the module: a UBX poll that a u-blox acknowledges,
+//               then a PMTK test packet that a MediaTek acknowledges. Boot
+//               banners ($GPTXT "u-blox", $PMTK011) pick which goes first.
+//   3. Configure  one command at a time (UBX CFG-MSG per NMEA message and
+//               CFG-RATE, or PMTK314 and PMTK220), each waiting for its ACK
+//               with retries.
+//   4. Switch   if the module is not at the target baud, send CFG-PRT or
+//               PMTK251, follow it, and verify NMEA still arrives; revert if
+//               it does not.
+//
+// Anything that fails degrades gracefully: an unknown module is left as it
+// is (the output profile still filters its output), and a refused command
+// only marks the result Partial. The configurator talks to the UART through
+// ConfigPort, so on the host it runs against canned transcripts.
+
+#ifndef VX8_MODULE_CONFIG_H
+#define VX8_MODULE_CONFIG_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+#include "ubx.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+enum class GpsModule : uint8_t { Unknown, Ublox, Mediatek };
+
+struct ConfigPort {
+  void (*write)(void* ctx, const uint8_t* data, uint8_t len);
+  void (*setBaud)(void* ctx, uint32_t baud);
+  void* ctx;
+};
+
+struct ModuleConfigOptions {
+  uint32_t baud;           // baud rate to leave the module at
+  uint16_t fixIntervalMs;  // navigation update period
+  uint8_t sentences;       // VX8_SENTENCE_* mask to enable
+
+  static ModuleConfigOptions defaults();
+};
+
+class ModuleConfigurator {
+ public:
+  enum class Result : uint8_t {
+    Pending,
+    Configured,    // identified, every command acknowledged, at target baud
+    Partial,       // identified, but a command or the baud change failed
+    Unidentified,  // NMEA seen but no UBX/PMTK answer; left unchanged
+    NoSignal,      // nothing valid at any candidate baud
+  };
+
+  // Timeouts in milliseconds.
+  static const uint16_t kListenMs = 1500;
+  static const uint16_t kAckMs = 400;
+  static const uint16_t kDrainMs = 150;
+  static const uint16_t kVerifyMs = 2500;
+  static const uint8_t kAttempts = 3;
+
+  ModuleConfigurator(const ConfigPort& port,
+                     const ModuleConfigOptions& options);
+
+  void begin(uint32_t nowMs);
+
+  // Every byte received from the module while configuring.
+  void onRxByte(uint8_t b);
+
+  // Advances the state machine; returns Pending until finished.
+  Result poll(uint32_t nowMs);
+
+  Result result() const { return result_; }
+  GpsModule module() const { return module_; }
+  // Baud rate the module is running at (valid once finished, except after
+  // NoSignal).
+  uint32_t baud() const { return baud_; }
+  // Commands refused or unanswered, plus a failed baud change.
+  uint8_t failures() const { return failures_; }
+
+ private:
+  enum class Phase : uint8_t {
+    Detect, ProbeUbx, ProbeMtk, Configure, SwitchBaud, Verify, Done
+  };
+  enum class Ack : uint8_t { None, Positive, Negative };
+
+  void enter(Phase phase, uint32_t nowMs, uint16_t timeoutMs);
+  bool expired(uint32_t nowMs) const;
+  void startProbe(Phase probe, uint32_t nowMs);
+  void sendStep(uint32_t nowMs);
+  void afterConfigure(uint32_t nowMs);
+  uint8_t buildStep(uint8_t step, uint8_t* out);
+  void send(const uint8_t* data, uint8_t len);
+  void setBaud(uint32_t baud);
+  void finish(Result result);
+  void onSentence();
+
+  ConfigPort port_;
+  ModuleConfigOptions options_;
+  NmeaParser nmea_;
+  ubx::Parser ubx_;
+
+  Phase phase_;
+  Result result_;
+  GpsModule module_;
+  GpsModule hint_;
+  uint32_t deadline_;
+  uint32_t baud_;
+  uint8_t candidate_;
+  uint8_t step_;
+  uint8_t attempts_;
+  uint8_t failures_;
+  bool probedOther_;
+  bool sawTraffic_;
+  Ack ack_;
+  // What the outstanding command expects back.
+  uint8_t expectClass_;
+  uint8_t expectId_;
+  uint16_t expectPmtk_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_MODULE_CONFIG_H
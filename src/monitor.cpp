@@ -0,0 +1,140 @@
+#include "monitor.h"
+
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+static_assert(Monitor::kMaxReport <= Bridge::kMaxInject,
+              "a report sentence must fit one injection");
+
+namespace {
+
+// Multi-byte counters written by an interrupt can tear on an 8-bit MCU:
+// read until two reads agree.
+uint32_t stableRead(const uint32_t& v) {
+  uint32_t a, b;
+  do {
+    a = v;
+    VX8_BARRIER();
+    b = v;
+  } while (a != b);
+  return a;
+}
+
+uint16_t stableRead(const uint16_t& v) {
+  uint16_t a, b;
+  do {
+    a = v;
+    VX8_BARRIER();
+    b = v;
+  } while (a != b);
+  return a;
+}
+
+uint8_t field(uint32_t v, char* out) {
+  out[0] = ',';
+  return static_cast<uint8_t>(1 + formatUnsigned(v, out + 1));
+}
+
+bool isFix(const NmeaParser& p) {
+  if (p.type() == SentenceType::GGA) {
+    const NmeaField q = p.field(6);
+    return !q.empty() && q.data[0] != '0';
+  }
+  if (p.type() == SentenceType::RMC) return p.field(2).equals("A");
+  return false;
+}
+
+}  // namespace
+
+Monitor::Monitor()
+    : loopStart_(0),
+      maxLoopUs_(0),
+      lastFixMs_(0),
+      haveFix_(false),
+      fixSeen_(false),
+      nextPart_(0),
+      queries_(0) {}
+
+bool Monitor::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<Monitor*>(ctx)->apply(p, raw);
+}
+
+bool Monitor::apply(const NmeaParser& p, SentenceView&) {
+  if (p.type() == SentenceType::Proprietary) {
+    if (!p.field(0).equals("PVX8Q")) return true;
+    ++queries_;
+    requestReport();
+    return false;
+  }
+  if (isFix(p)) fixSeen_ = true;
+  return true;
+}
+
+void Monitor::endLoop(uint32_t nowUs) {
+  const uint32_t took = nowUs - loopStart_;
+  if (took > maxLoopUs_) maxLoopUs_ = took;
+}
+
+void Monitor::update(uint32_t nowMs, Bridge& bridge) {
+  if (fixSeen_) {
+    fixSeen_ = false;
+    haveFix_ = true;
+    lastFixMs_ = nowMs;
+  }
+  if (!nextPart_ || bridge.injectPending()) return;
+  char buf[kMaxReport];
+  const uint8_t n = formatReport(snapshot(nowMs, bridge), nextPart_, buf);
+  if (bridge.inject(reinterpret_cast<const uint8_t*>(buf), n)) {
+    nextPart_ = nextPart_ == 1 ? 2 : 0;
+  }
+}
+
+Counters Monitor::snapshot(uint32_t nowMs, const Bridge& bridge) const {
+  const BridgeStats& s = bridge.stats();
+  Counters c;
+  c.bytesIn = s.bytesIn;
+  c.bytesOut = stableRead(s.bytesOut);
+  c.rxOverruns = stableRead(s.rxOverruns);
+  c.txQueueFull = s.txQueueFull;
+  c.sentencesForwarded = s.sentencesForwarded;
+  c.checksumErrors = s.checksumErrors;
+  c.parseErrors = s.parseErrors;
+  c.sentencesFiltered = s.sentencesFiltered;
+  c.fixAgeS = Counters::kNoFix;
+  if (haveFix_) {
+    const uint32_t age = (nowMs - lastFixMs_) / 1000;
+    c.fixAgeS = static_cast<uint16_t>(age < Counters::kNoFix - 1
+                                          ? age
+                                          : Counters::kNoFix - 1);
+  }
+  c.maxLoopUs = maxLoopUs_;
+  return c;
+}
+
+uint8_t Monitor::formatReport(const Counters& c, uint8_t part, char* out) {
+  const char head[] = "$PVX8S,1";
+  uint8_t n = 0;
+  for (; head[n]; ++n) out[n] = head[n];
+  if (part == 1) {
+    n = static_cast<uint8_t>(n + field(c.bytesIn, out + n));
+    n = static_cast<uint8_t>(n + field(c.bytesOut, out + n));
+    n = static_cast<uint8_t>(n + field(c.rxOverruns, out + n));
+    n = static_cast<uint8_t>(n + field(c.txQueueFull, out + n));
+    n = static_cast<uint8_t>(n + field(c.sentencesForwarded, out + n));
+  } else {
+    out[n - 1] = '2';
+    n = static_cast<uint8_t>(n + field(c.checksumErrors, out + n));
+    n = static_cast<uint8_t>(n + field(c.parseErrors, out + n));
+    n = static_cast<uint8_t>(n + field(c.sentencesFiltered, out + n));
+    if (c.fixAgeS == Counters::kNoFix) {
+      out[n++] = ',';
+    } else {
+      n = static_cast<uint8_t>(n + field(c.fixAgeS, out + n));
+    }
+    n = static_cast<uint8_t>(n + field(c.maxLoopUs, out + n));
+  }
+  return finishSentence(out, n);
+}
+
+}  // namespace vx8
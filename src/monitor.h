@@ -0,0 +1,90 @@
+// Always-on diagnostics, readable in the field.
+//
+// The counting itself is done where it is cheapest: the RX and TX interrupts
+// only increment (BridgeStats::rxOverruns, bytesOut), and everything else is
+// counted by Bridge::poll() in the main loop. The monitor adds what the
+// bridge cannot see: how long ago the last valid fix was, and the longest
+// main-loop pass. Nothing is formatted until someone asks.
+//
+// Asking is a $PVX8Q sentence on the GPS-side UART (or requestReport(), e.g.
+// from a spare pin). The answer is two sentences injected on the TX line:
+//   $PVX8S,1,<bytes in>,<bytes out>,<rx overruns>,<tx queue full>,
+//            <forwarded>*hh
+//   $PVX8S,2,<checksum errors>,<parse errors>,<filtered>,<fix age s>,
+//            <max loop us>*hh
+// The fix age is empty until the first fix and saturates at 65534.
+//
+// The monitor must be the first filter stage, so that the output profile
+// does not drop the query before it is seen.
+
+#ifndef VX8_MONITOR_H
+#define VX8_MONITOR_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "nmea_parser.h"
+#include "sentence_edit.h"
+
+namespace vx8 {
+
+struct Counters {
+  uint32_t bytesIn;
+  uint32_t bytesOut;
+  uint16_t rxOverruns;
+  uint16_t txQueueFull;
+  uint16_t sentencesForwarded;
+  uint16_t checksumErrors;
+  uint16_t parseErrors;
+  uint16_t sentencesFiltered;
+  uint16_t fixAgeS;  // kNoFix before the first fix
+  uint32_t maxLoopUs;
+
+  static const uint16_t kNoFix = 0xFFFF;
+};
+
+class Monitor {
+ public:
+  // Longest report sentence.
+  static const uint8_t kMaxReport = 56;
+
+  Monitor();
+
+  // Filter stage: notes valid fixes, swallows queries.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  // Main loop, around the work of one pass (before any sleep), with a
+  // microsecond clock.
+  void beginLoop(uint32_t nowUs) { loopStart_ = nowUs; }
+  void endLoop(uint32_t nowUs);
+
+  // Main loop, after Bridge::poll(): timestamps fixes seen by the filter and
+  // injects the next part of a requested report when the TX line is free.
+  void update(uint32_t nowMs, Bridge& bridge);
+
+  void requestReport() { nextPart_ = 1; }
+  bool reportPending() const { return nextPart_ != 0; }
+
+  // A consistent copy of the counters, safe against the interrupts.
+  Counters snapshot(uint32_t nowMs, const Bridge& bridge) const;
+
+  // Writes report sentence `part` (1 or 2) and returns its length.
+  static uint8_t formatReport(const Counters& c, uint8_t part, char* out);
+
+  uint32_t maxLoopUs() const { return maxLoopUs_; }
+  uint16_t queries() const { return queries_; }
+
+ private:
+  uint32_t loopStart_;
+  uint32_t maxLoopUs_;
+  uint32_t lastFixMs_;
+  bool haveFix_;
+  bool fixSeen_;  // by the filter since the last update()
+  uint8_t nextPart_;
+  uint16_t queries_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_MONITOR_H
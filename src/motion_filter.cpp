@@ -0,0 +1,291 @@
+#include "motion_filter.h"
+
+#include "fixed_math.h"
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+namespace {
+
+const uint32_t kCentisecondsPerDay = 24U * 3600U * 100U;
+
+// Epochs further apart than this restart the tracker.
+const uint16_t kMaxGapCs = 1000;
+
+// Residuals beyond ~70 km (a jump, a restart, the antimeridian) restart the
+// tracker; the bound also keeps the Q8 products inside 32 bits.
+const int32_t kMaxResidual = static_cast<int32_t>(1) << 22;
+const int32_t kMaxVelocity = static_cast<int32_t>(1) << 20;
+
+// Field indices.
+const uint8_t kGgaLatField = 2;
+const uint8_t kRmcLatField = 3;
+const uint8_t kRmcSpeedField = 7;
+const uint8_t kRmcCourseField = 8;
+
+const uint8_t kMaxFieldText = 12;
+
+// v * q / 256, rounded half away from zero.
+int32_t mulQ8(int32_t v, uint8_t q) {
+  const int32_t p = v * q;
+  return (p + (p < 0 ? -128 : 128)) / 256;
+}
+
+int32_t clamp(int32_t v, int32_t limit) {
+  return v > limit ? limit : (v < -limit ? -limit : v);
+}
+
+uint8_t findDot(const NmeaField& f) {
+  uint8_t i = 0;
+  while (i < f.len && f.data[i] != '.') ++i;
+  return i;
+}
+
+// Overwrites `f` (at `offset` in `raw`) with `text`, which has the same
+// length. Returns whether anything changed.
+bool replaceText(SentenceView& raw, uint8_t offset, const NmeaField& f,
+                 const char* text) {
+  bool changed = false;
+  for (uint8_t i = 0; i < f.len; ++i) {
+    if (f.data[i] != text[i]) {
+      raw.set(static_cast<uint8_t>(offset + i), text[i]);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+// Rewrites an angle field and its hemisphere field with `value`, keeping the
+// original number of minute decimals.
+bool writeAngle(const NmeaParser& p, SentenceView& raw, uint8_t field,
+                uint8_t degreeDigits, int32_t value, char positive,
+                char negative) {
+  const NmeaField f = p.field(field);
+  const NmeaField hemisphere = p.field(static_cast<uint8_t>(field + 1));
+  const uint8_t dot = findDot(f);
+  if (dot != degreeDigits + 2 || dot == f.len || hemisphere.len != 1) {
+    return false;
+  }
+  const uint8_t decimals = static_cast<uint8_t>(f.len - dot - 1);
+  if (decimals > 5) return false;
+
+  char text[kMaxFieldText];
+  const int32_t magnitude = value < 0 ? -value : value;
+  if (formatNmeaAngle(magnitude, degreeDigits, decimals, text) != f.len) {
+    return false;
+  }
+  bool changed = replaceText(raw, p.fieldOffset(field), f, text);
+  const char h = value < 0 ? negative : positive;
+  if (hemisphere.data[0] != h) {
+    raw.set(p.fieldOffset(static_cast<uint8_t>(field + 1)), h);
+    changed = true;
+  }
+  return changed;
+}
+
+// Writes `centi` (hundredths) into a decimal field of the same width, giving
+// up fraction digits if the integer part needs the room.
+bool writeHundredths(const NmeaParser& p, SentenceView& raw, uint8_t field,
+                     uint16_t centi) {
+  const NmeaField f = p.field(field);
+  if (f.len == 0 || f.len > kMaxFieldText) return false;
+  const uint8_t dot = findDot(f);
+  uint8_t decimals = dot < f.len ? static_cast<uint8_t>(f.len - dot - 1) : 0;
+
+  const uint16_t whole = centi / 100;
+  const uint8_t fraction = static_cast<uint8_t>(centi % 100);
+  uint8_t digits = 1;
+  for (uint16_t v = whole; v >= 10; v /= 10) ++digits;
+  while (decimals > 0 && digits + decimals + 1 > f.len) --decimals;
+  const uint8_t intWidth =
+      static_cast<uint8_t>(f.len - (decimals ? decimals + 1 : 0));
+  // intWidth never exceeds f.len; the explicit bound lets the compiler see
+  // the writes below stay inside text[].
+  if (intWidth == 0 || intWidth > kMaxFieldText || digits > intWidth) {
+    return false;
+  }
+
+  char text[kMaxFieldText];
+  uint16_t v = whole;
+  for (uint8_t i = intWidth; i > 0; --i) {
+    text[i - 1] = static_cast<char>('0' + v % 10);
+    v /= 10;
+  }
+  if (decimals) {
+    text[intWidth] = '.';
+    for (uint8_t i = 0; i < decimals; ++i) {
+      const uint8_t d = i == 0 ? fraction / 10 : (i == 1 ? fraction % 10 : 0);
+      text[intWidth + 1 + i] = static_cast<char>('0' + d);
+    }
+  }
+  return replaceText(raw, p.fieldOffset(field), f, text);
+}
+
+}  // namespace
+
+MotionConfig MotionConfig::defaults() {
+  MotionConfig c;
+  c.holdSpeed = VX8_MOTION_HOLD_SPEED;
+  c.maxHdop = VX8_MOTION_MAX_HDOP;
+  c.holdFixes = VX8_MOTION_HOLD_FIXES;
+  c.moveFixes = VX8_MOTION_MOVE_FIXES;
+  c.releaseDm = VX8_MOTION_RELEASE_DM;
+  c.headingSpeed = VX8_MOTION_HEADING_SPEED;
+  c.alpha = 128;
+  c.beta = 32;
+  return c;
+}
+
+MotionFilter::MotionFilter() : MotionFilter(MotionConfig::defaults()) {}
+
+MotionFilter::MotionFilter(const MotionConfig& config)
+    : config_(config),
+      lat_(),
+      lon_(),
+      anchorLat_(0),
+      anchorLon_(0),
+      outLat_(0),
+      outLon_(0),
+      epochKey_(0),
+      speed_(0),
+      hdop_(kNoValue16),
+      course_(0),
+      stillFixes_(0),
+      movingFixes_(0),
+      tracking_(false),
+      holding_(false),
+      haveCourse_(false) {}
+
+bool MotionFilter::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<MotionFilter*>(ctx)->apply(p, raw);
+}
+
+bool MotionFilter::apply(const NmeaParser& p, SentenceView& raw) {
+  UtcTime time;
+  int32_t lat, lon;
+  uint8_t latField;
+  const SentenceType type = p.type();
+  if (type == SentenceType::GGA) {
+    GgaData g;
+    if (!decodeGga(p, g) || !g.hasPosition || g.quality == 0) return true;
+    hdop_ = g.hdop;
+    time = g.time;
+    lat = g.latitude;
+    lon = g.longitude;
+    latField = kGgaLatField;
+  } else if (type == SentenceType::RMC) {
+    RmcData r;
+    if (!decodeRmc(p, r) || !r.valid || !r.hasPosition) return true;
+    speed_ = r.speed;
+    if (r.speed >= config_.headingSpeed && r.course != kNoValue16) {
+      course_ = r.course;
+      haveCourse_ = true;
+    }
+    time = r.time;
+    lat = r.latitude;
+    lon = r.longitude;
+    latField = kRmcLatField;
+  } else {
+    return true;
+  }
+
+  const uint32_t key = time.secondOfDay() * 100 + time.centisecond;
+  if (!tracking_ || key != epochKey_) update(lat, lon, key);
+
+  bool edited = rewritePosition(p, raw, latField);
+  if (type == SentenceType::RMC) edited |= rewriteMotion(p, raw);
+  if (edited) raw.updateChecksum();
+  return true;
+}
+
+void MotionFilter::update(int32_t lat, int32_t lon, uint32_t key) {
+  uint32_t dt = 0;
+  if (tracking_) {
+    dt = key >= epochKey_ ? key - epochKey_
+                          : key + kCentisecondsPerDay - epochKey_;
+  }
+  epochKey_ = key;
+  tracking_ = true;
+
+  const uint16_t dtCs = static_cast<uint16_t>(dt);
+  if (dt == 0 || dt > kMaxGapCs || !track(lat_, lat, dtCs) ||
+      !track(lon_, lon, dtCs)) {
+    lat_.x = lat;
+    lat_.v = 0;
+    lon_.x = lon;
+    lon_.v = 0;
+    holding_ = false;
+    stillFixes_ = 0;
+    movingFixes_ = 0;
+  }
+
+  updateHold();
+  outLat_ = holding_ ? anchorLat_ : lat_.x;
+  outLon_ = holding_ ? anchorLon_ : lon_.x;
+}
+
+// Predicts the axis forward by `dtCs` and corrects it towards the measured
+// `z`. Returns false, leaving the axis alone, if `z` is implausibly far off.
+bool MotionFilter::track(Axis& a, int32_t z, uint16_t dtCs) const {
+  const int32_t predicted = a.x + a.v * dtCs / 100;
+  const int32_t residual = z - predicted;
+  if (residual > kMaxResidual || residual < -kMaxResidual) return false;
+  a.x = predicted + mulQ8(residual, config_.alpha);
+  a.v = clamp(a.v + mulQ8(residual, config_.beta) * 100 / dtCs, kMaxVelocity);
+  return true;
+}
+
+void MotionFilter::updateHold() {
+  const bool trusted = hdop_ <= config_.maxHdop;
+  if (speed_ >= config_.holdSpeed && trusted) {
+    stillFixes_ = 0;
+    if (movingFixes_ < 0xFF) ++movingFixes_;
+  } else {
+    movingFixes_ = 0;
+    if (stillFixes_ < 0xFF) ++stillFixes_;
+  }
+
+  if (!holding_) {
+    if (stillFixes_ >= config_.holdFixes) {
+      holding_ = true;
+      anchorLat_ = lat_.x;
+      anchorLon_ = lon_.x;
+    }
+    return;
+  }
+
+  bool release = movingFixes_ >= config_.moveFixes;
+  if (!release && trusted) {
+    const uint16_t scale = hdop_ > 100 ? hdop_ : 100;
+    const uint32_t radius =
+        static_cast<uint32_t>(config_.releaseDm) * scale / 100;
+    release = distanceDecimetres(nmeaToMicrodegrees(anchorLat_),
+                                 nmeaToMicrodegrees(anchorLon_),
+                                 nmeaToMicrodegrees(lat_.x),
+                                 nmeaToMicrodegrees(lon_.x)) > radius;
+  }
+  if (release) {
+    holding_ = false;
+    stillFixes_ = 0;
+  }
+}
+
+bool MotionFilter::rewritePosition(const NmeaParser& p, SentenceView& raw,
+                                   uint8_t latField) {
+  bool edited = writeAngle(p, raw, latField, 2, outLat_, 'N', 'S');
+  edited |= writeAngle(p, raw, static_cast<uint8_t>(latField + 2), 3, outLon_,
+                       'E', 'W');
+  return edited;
+}
+
+bool MotionFilter::rewriteMotion(const NmeaParser& p, SentenceView& raw) {
+  bool edited = false;
+  if (holding_) edited |= writeHundredths(p, raw, kRmcSpeedField, 0);
+  if (speed_ < config_.headingSpeed && haveCourse_ &&
+      !p.field(kRmcCourseField).empty()) {
+    edited |= writeHundredths(p, raw, kRmcCourseField, course_);
+  }
+  return edited;
+}
+
+}  // namespace vx8
@@ -0,0 +1,100 @@
+// Position hold and smoothing for a radio that beacons on movement.
+//
+// A stationary receiver still reports a position that wanders by metres and
+// a course that spins at random, which the VX-8R's APRS logic takes for
+// movement (and SmartBeaconing for corners). This optional filter stage
+// rewrites the position, speed and course fields of GGA and RMC in place:
+//   - lat/lon go through an alpha-beta tracker per axis, in 1e-5 arc-minute
+//     fixed point, which removes jitter without lagging a steady course;
+//   - after a few slow (or poor-HDOP) fixes the position is held: GGA and RMC
+//     report the same anchored position and RMC a speed of zero until
+//     several fixes in a row are fast with good HDOP, or the smoothed
+//     position leaves an HDOP-scaled radius around the anchor;
+//   - below a speed threshold RMC repeats the last course seen above it.
+// Both sentences of an epoch carry the same output position. Fixes without
+// a valid position pass through untouched, as does everything else.
+//
+// Rewritten fields keep their width: angles keep their decimals, and a
+// course that would not fit its field is left alone. Run it after the output
+// profile (see FilterChain) so it sees one epoch per second.
+
+#ifndef VX8_MOTION_FILTER_H
+#define VX8_MOTION_FILTER_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+struct MotionConfig {
+  uint16_t holdSpeed;      // centi-knots; slower fixes are stationary
+  uint16_t maxHdop;        // hundredths; worse fixes are never movement
+  uint8_t holdFixes;       // stationary fixes in a row before holding
+  uint8_t moveFixes;       // moving fixes in a row before releasing
+  uint16_t releaseDm;      // drift from the anchor that releases the hold
+  uint16_t headingSpeed;   // centi-knots; slower fixes repeat the course
+  // Tracker gains in Q8 (256 = 1.0). Higher alpha follows the raw position
+  // more closely; beta sets how fast the velocity estimate adapts.
+  uint8_t alpha;
+  uint8_t beta;
+
+  static MotionConfig defaults();
+};
+
+class MotionFilter {
+ public:
+  MotionFilter();
+  explicit MotionFilter(const MotionConfig& config);
+
+  // Rewrites `raw` and returns true; never drops a sentence.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+
+  // Bridge::SentenceFilter adaptor; `ctx` is the MotionFilter.
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  bool holding() const { return holding_; }
+  // Position reported for the current epoch, in 1e-5 arc-minutes.
+  int32_t latitude() const { return outLat_; }
+  int32_t longitude() const { return outLon_; }
+
+  const MotionConfig& config() const { return config_; }
+
+ private:
+  // One alpha-beta tracker: position in 1e-5 arc-minutes, velocity in the
+  // same units per second.
+  struct Axis {
+    int32_t x;
+    int32_t v;
+  };
+
+  void update(int32_t lat, int32_t lon, uint32_t key);
+  bool track(Axis& a, int32_t z, uint16_t dtCs) const;
+  void updateHold();
+  bool rewritePosition(const NmeaParser& p, SentenceView& raw,
+                       uint8_t latField);
+  bool rewriteMotion(const NmeaParser& p, SentenceView& raw);
+
+  MotionConfig config_;
+  Axis lat_;
+  Axis lon_;
+  int32_t anchorLat_;
+  int32_t anchorLon_;
+  int32_t outLat_;
+  int32_t outLon_;
+  uint32_t epochKey_;  // centiseconds of day of the last update
+  uint16_t speed_;     // latest RMC speed, centi-knots
+  uint16_t hdop_;      // latest GGA HDOP, hundredths
+  uint16_t course_;    // last course seen at headingSpeed or faster
+  uint8_t stillFixes_;
+  uint8_t movingFixes_;
+  bool tracking_;
+  bool holding_;
+  bool haveCourse_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_MOTION_FILTER_H
@@ -0,0 +1,202 @@
+#include "nmea_parser.h"
+
+namespace vx8 {
+
+namespace {
+
+// Payload characters between '$' and the checksum: the sentence limit minus
+// the CR LF terminator.
+const uint8_t kMaxStored = NmeaParser::kMaxSentence - 2;
+
+// Returns 0-15, or 0xFF for a byte that is not a hex digit.
+uint8_t hexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return 0xFF;
+}
+
+bool match3(const char* p, char a, char b, char c) {
+  return p[0] == a && p[1] == b && p[2] == c;
+}
+
+}  // namespace
+
+bool NmeaField::equals(const char* s) const {
+  uint8_t i = 0;
+  for (; i < len; ++i) {
+    if (s[i] != data[i]) return false;
+  }
+  return s[i] == '\0';
+}
+
+void formatChecksum(uint8_t sum, char out[2]) {
+  static const char kHex[] = "0123456789ABCDEF";
+  out[0] = kHex[sum >> 4];
+  out[1] = kHex[sum & 0x0F];
+}
+
+uint8_t finishSentence(char* buf, uint8_t len) {
+  uint8_t sum = 0;
+  for (uint8_t i = 1; i < len; ++i) sum ^= static_cast<uint8_t>(buf[i]);
+  buf[len++] = '*';
+  formatChecksum(sum, buf + len);
+  len = static_cast<uint8_t>(len + 2);
+  buf[len++] = '\r';
+  buf[len++] = '\n';
+  return len;
+}
+
+uint8_t formatUnsigned(uint32_t v, char* out) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v);
+  for (uint8_t i = 0; i < n; ++i) out[i] = digits[n - 1 - i];
+  return n;
+}
+
+void NmeaParser::reset() {
+  len_ = 0;
+  fieldCount_ = 0;
+  starOffset_ = 0;
+  sum_ = 0;
+  expected_ = 0;
+  state_ = State::Idle;
+  error_ = Error::None;
+  talker_ = Talker::Unknown;
+  type_ = SentenceType::Unknown;
+  buf_[0] = '\0';
+}
+
+NmeaParser::Status NmeaParser::fail(Error e) {
+  error_ = e;
+  state_ = State::Idle;
+  len_ = 0;
+  return Status::Error;
+}
+
+NmeaParser::Status NmeaParser::feed(uint8_t c) {
+  if (c == '$') {
+    // Always resynchronise on a start delimiter; a sentence cut short by one
+    // is reported so the caller can count it.
+    const bool truncated = state_ != State::Idle;
+    buf_[0] = '$';
+    len_ = 1;
+    starts_[0] = 1;
+    fieldCount_ = 1;
+    sum_ = 0;
+    state_ = State::Body;
+    talker_ = Talker::Unknown;
+    type_ = SentenceType::Unknown;
+    if (truncated) {
+      error_ = Error::MissingChecksum;
+      return Status::Error;
+    }
+    return Status::Busy;
+  }
+
+  switch (state_) {
+    case State::Idle:
+      return Status::Busy;
+
+    case State::Body:
+      if (c == '\r' || c == '\n') return fail(Error::MissingChecksum);
+      if (c < 0x20 || c > 0x7E) return fail(Error::BadCharacter);
+      if (len_ >= kMaxStored) return fail(Error::Overflow);
+      if (c == '*') {
+        starOffset_ = len_;
+        buf_[len_++] = '*';
+        state_ = State::Checksum1;
+        return Status::Busy;
+      }
+      buf_[len_++] = static_cast<char>(c);
+      sum_ ^= c;
+      if (c == ',') {
+        if (fieldCount_ >= kMaxFields) return fail(Error::Overflow);
+        starts_[fieldCount_++] = len_;
+      }
+      return Status::Busy;
+
+    case State::Checksum1: {
+      const uint8_t v = hexValue(c);
+      if (v == 0xFF || len_ >= kMaxStored) return fail(Error::BadCharacter);
+      expected_ = static_cast<uint8_t>(v << 4);
+      buf_[len_++] = static_cast<char>(c);
+      state_ = State::Checksum2;
+      return Status::Busy;
+    }
+
+    case State::Checksum2: {
+      const uint8_t v = hexValue(c);
+      if (v == 0xFF || len_ >= kMaxStored) return fail(Error::BadCharacter);
+      expected_ |= v;
+      buf_[len_++] = static_cast<char>(c);
+      if (expected_ != sum_) return fail(Error::Checksum);
+      state_ = State::Terminator;
+      return Status::Busy;
+    }
+
+    case State::Terminator:
+      if (c != '\r' && c != '\n') return fail(Error::BadCharacter);
+      buf_[len_] = '\0';
+      classify();
+      error_ = Error::None;
+      state_ = State::Idle;
+      return Status::Sentence;
+  }
+  return Status::Busy;
+}
+
+NmeaField NmeaParser::field(uint8_t index) const {
+  NmeaField f;
+  if (index >= fieldCount_) {
+    f.data = buf_ + len_;
+    f.len = 0;
+    return f;
+  }
+  const uint8_t start = starts_[index];
+  const uint8_t end =
+      index + 1 < fieldCount_ ? starts_[index + 1] - 1 : starOffset_;
+  f.data = buf_ + start;
+  f.len = static_cast<uint8_t>(end - start);
+  return f;
+}
+
+void NmeaParser::classify() {
+  const NmeaField addr = field(0);
+  if (addr.len >= 1 && addr.data[0] == 'P') {
+    talker_ = Talker::Proprietary;
+    type_ = SentenceType::Proprietary;
+    return;
+  }
+  if (addr.len != 5) return;
+
+  const char* a = addr.data;
+  if (a[0] == 'G' && a[1] == 'P') {
+    talker_ = Talker::GP;
+  } else if (a[0] == 'G' && a[1] == 'N') {
+    talker_ = Talker::GN;
+  } else if (a[0] == 'G' && a[1] == 'L') {
+    talker_ = Talker::GL;
+  } else if (a[0] == 'G' && a[1] == 'A') {
+    talker_ = Talker::GA;
+  } else if ((a[0] == 'G' && a[1] == 'B') || (a[0] == 'B' && a[1] == 'D')) {
+    talker_ = Talker::GB;
+  }
+
+  const char* t = a + 2;
+  if (match3(t, 'G', 'G', 'A')) {
+    type_ = SentenceType::GGA;
+  } else if (match3(t, 'R', 'M', 'C')) {
+    type_ = SentenceType::RMC;
+  } else if (match3(t, 'G', 'S', 'A')) {
+    type_ = SentenceType::GSA;
+  } else if (match3(t, 'G', 'S', 'V')) {
+    type_ = SentenceType::GSV;
+  }
+}
+
+}  // namespace vx8
@@ -0,0 +1,139 @@
+// Incremental NMEA 0183 sentence parser.
+//
+// The parser is fed one byte at a time and never allocates: the sentence is
+// kept in a fixed 83-byte buffer and fields are exposed as (pointer, length)
+// views into that buffer. Field boundaries and the running checksum are
+// tracked as bytes arrive, so feed() does a constant amount of work per byte
+// and nothing proportional to the sentence length ever runs inside it.
+//
+// Timing (ATmega328 @ 16 MHz, 9600 baud 8N1): one byte arrives every 1.04 ms,
+// i.e. every ~16,600 cycles. feed() has no loops; the only non-trivial work
+// is on the terminating byte, where the address field is classified with a
+// fixed five-character compare. The design target is 100 cycles per byte
+// worst case, well under 1% of the byte period; it has not been measured on
+// an AVR. Typed decoding (nmea_sentences.h) runs once per sentence from the
+// main loop and is bounded by the 82-byte sentence length.
+
+#ifndef VX8_NMEA_PARSER_H
+#define VX8_NMEA_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vx8 {
+
+enum class Talker : uint8_t {
+  Unknown,
+  GP,  // GPS
+  GN,  // combined GNSS
+  GL,  // GLONASS
+  GA,  // Galileo
+  GB,  // BeiDou (also reported as BD)
+  Proprietary,
+};
+
+enum class SentenceType : uint8_t {
+  Unknown,
+  GGA,
+  RMC,
+  GSA,
+  GSV,
+  Proprietary,
+};
+
+// A view of one comma-separated field. Not NUL terminated.
+struct NmeaField {
+  const char* data;
+  uint8_t len;
+
+  bool empty() const { return len == 0; }
+  bool equals(const char* s) const;
+};
+
+class NmeaParser {
+ public:
+  // NMEA 0183 limits a sentence to 82 characters including '$' and CR LF.
+  static const uint8_t kMaxSentence = 82;
+  // Address field plus the longest sentence we decode (GSV, 19 data fields)
+  // with headroom for vendor extensions.
+  static const uint8_t kMaxFields = 24;
+
+  enum class Status : uint8_t {
+    Busy,      // byte consumed, no complete sentence yet
+    Sentence,  // a checksum-valid sentence is available
+    Error,     // the sentence in progress was discarded, see lastError()
+  };
+
+  enum class Error : uint8_t {
+    None,
+    Checksum,         // checksum present but does not match
+    MissingChecksum,  // terminator reached before '*hh'
+    Overflow,         // longer than kMaxSentence or too many fields
+    BadCharacter,     // non-printable byte or bad hex digit
+  };
+
+  NmeaParser() { reset(); }
+
+  // Drops any partial sentence and waits for the next '$'.
+  void reset();
+
+  // Consumes one byte. When Status::Sentence is returned the accessors below
+  // describe that sentence until the next call to feed().
+  Status feed(uint8_t c);
+
+  Error lastError() const { return error_; }
+
+  // True while bytes after a '$' are being collected.
+  bool inSentence() const { return state_ != State::Idle; }
+
+  // The sentence from '$' up to, but excluding, the CR LF terminator.
+  const char* sentence() const { return buf_; }
+  uint8_t length() const { return len_; }
+
+  Talker talker() const { return talker_; }
+  SentenceType type() const { return type_; }
+
+  // Field 0 is the address field ("GPGGA"); the checksum is not a field.
+  uint8_t fieldCount() const { return fieldCount_; }
+  NmeaField field(uint8_t index) const;
+
+  // Offset of the first character of a field from the '$'. Valid for
+  // index < fieldCount(); used to patch a sentence held elsewhere.
+  uint8_t fieldOffset(uint8_t index) const { return starts_[index]; }
+
+  // Offset of the '*' that introduces the checksum.
+  uint8_t checksumOffset() const { return starOffset_; }
+
+ private:
+  enum class State : uint8_t { Idle, Body, Checksum1, Checksum2, Terminator };
+
+  Status fail(Error e);
+  void classify();
+
+  char buf_[kMaxSentence + 1];
+  uint8_t starts_[kMaxFields];
+  uint8_t len_;
+  uint8_t fieldCount_;
+  uint8_t starOffset_;
+  uint8_t sum_;
+  uint8_t expected_;
+  State state_;
+  Error error_;
+  Talker talker_;
+  SentenceType type_;
+};
+
+// Two upper-case hex digits for a checksum byte.
+void formatChecksum(uint8_t sum, char out[2]);
+
+// Completes an outgoing sentence: `buf` holds `len` characters starting with
+// '$' (or '!'); appends "*hh\r\n" and returns the new length. `buf` needs
+// five spare bytes.
+uint8_t finishSentence(char* buf, uint8_t len);
+
+// Writes `v` in decimal at `out`, returns the digit count (at most 10).
+uint8_t formatUnsigned(uint32_t v, char* out);
+
+}  // namespace vx8
+
+#endif  // VX8_NMEA_PARSER_H
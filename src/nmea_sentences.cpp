@@ -0,0 +1,229 @@
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+namespace {
+
+// Largest int32_t, spelled out: avr-libc hides INT32_MAX from C++.
+const int32_t kMaxFixed = 0x7FFFFFFFL;
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Two-digit decimal at p; caller guarantees two characters are present.
+bool twoDigits(const char* p, uint8_t& out) {
+  if (!isDigit(p[0]) || !isDigit(p[1])) return false;
+  out = static_cast<uint8_t>((p[0] - '0') * 10 + (p[1] - '0'));
+  return true;
+}
+
+uint16_t optionalFixed16(const NmeaField& f, uint8_t decimals) {
+  int32_t v;
+  if (!parseFixed(f, decimals, v) || v < 0 || v > 0xFFFE) return kNoValue16;
+  return static_cast<uint16_t>(v);
+}
+
+}  // namespace
+
+bool parseUnsigned(const NmeaField& f, uint32_t& out) {
+  if (f.empty() || f.len > 9) return false;
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < f.len; ++i) {
+    if (!isDigit(f.data[i])) return false;
+    v = v * 10 + static_cast<uint32_t>(f.data[i] - '0');
+  }
+  out = v;
+  return true;
+}
+
+bool parseFixed(const NmeaField& f, uint8_t decimals, int32_t& out) {
+  if (f.empty()) return false;
+  uint8_t i = 0;
+  bool negative = false;
+  if (f.data[0] == '-') {
+    negative = true;
+    i = 1;
+  }
+  int32_t whole = 0;
+  uint8_t digits = 0;
+  for (; i < f.len && f.data[i] != '.'; ++i) {
+    if (!isDigit(f.data[i]) || ++digits > 9) return false;
+    whole = whole * 10 + (f.data[i] - '0');
+  }
+  int32_t frac = 0;
+  uint8_t fracDigits = 0;
+  if (i < f.len) {
+    for (++i; i < f.len; ++i) {
+      if (!isDigit(f.data[i])) return false;
+      ++digits;
+      if (fracDigits < decimals) {
+        frac = frac * 10 + (f.data[i] - '0');
+        ++fracDigits;
+      }
+    }
+  }
+  // A bare "-" or "." has no digits at all.
+  if (digits == 0 || decimals > 9) return false;
+  for (; fracDigits < decimals; ++fracDigits) frac *= 10;
+  int32_t scale = 1;
+  for (uint8_t d = 0; d < decimals; ++d) scale *= 10;
+  if (whole > (kMaxFixed - frac) / scale) return false;
+  const int32_t v = whole * scale + frac;
+  out = negative ? -v : v;
+  return true;
+}
+
+bool parseAngle(const NmeaField& value, const NmeaField& hemisphere,
+                int32_t& out) {
+  if (value.len < 4 || hemisphere.len != 1) return false;
+  // Degrees are everything before the two minute digits that precede '.'.
+  uint8_t dot = 0;
+  while (dot < value.len && value.data[dot] != '.') ++dot;
+  if (dot < 3 || dot > 5) return false;
+
+  int32_t degrees = 0;
+  for (uint8_t i = 0; i < dot - 2; ++i) {
+    if (!isDigit(value.data[i])) return false;
+    degrees = degrees * 10 + (value.data[i] - '0');
+  }
+  NmeaField minutes;
+  minutes.data = value.data + dot - 2;
+  minutes.len = static_cast<uint8_t>(value.len - (dot - 2));
+  int32_t m;
+  if (!parseFixed(minutes, 5, m) || m >= 6000000L) return false;
+
+  int32_t v = degrees * static_cast<int32_t>(6000000L) + m;
+  switch (hemisphere.data[0]) {
+    case 'N':
+    case 'E':
+      break;
+    case 'S':
+    case 'W':
+      v = -v;
+      break;
+    default:
+      return false;
+  }
+  out = v;
+  return true;
+}
+
+bool parseTime(const NmeaField& f, UtcTime& out) {
+  if (f.len < 6) return false;
+  if (!twoDigits(f.data, out.hour) || !twoDigits(f.data + 2, out.minute) ||
+      !twoDigits(f.data + 4, out.second)) {
+    return false;
+  }
+  out.centisecond = 0;
+  if (f.len > 7 && f.data[6] == '.') {
+    uint8_t cs = 0;
+    if (!isDigit(f.data[7])) return false;
+    cs = static_cast<uint8_t>((f.data[7] - '0') * 10);
+    if (f.len > 8) {
+      if (!isDigit(f.data[8])) return false;
+      cs = static_cast<uint8_t>(cs + (f.data[8] - '0'));
+    }
+    out.centisecond = cs;
+  }
+  return out.hour < 24 && out.minute < 60 && out.second < 61;
+}
+
+bool parseDate(const NmeaField& f, UtcDate& out) {
+  if (f.len != 6) return false;
+  return twoDigits(f.data, out.day) && twoDigits(f.data + 2, out.month) &&
+         twoDigits(f.data + 4, out.year) && out.day >= 1 && out.day <= 31 &&
+         out.month >= 1 && out.month <= 12;
+}
+
+// $GPGGA,time,lat,N,lon,E,quality,sats,hdop,alt,M,geoid,M,age,station
+bool decodeGga(const NmeaParser& p, GgaData& out) {
+  if (p.type() != SentenceType::GGA || p.fieldCount() < 10) return false;
+  if (!parseTime(p.field(1), out.time)) return false;
+
+  out.hasPosition = parseAngle(p.field(2), p.field(3), out.latitude) &&
+                    parseAngle(p.field(4), p.field(5), out.longitude);
+  if (!out.hasPosition) {
+    out.latitude = 0;
+    out.longitude = 0;
+  }
+
+  uint32_t v;
+  out.quality = parseUnsigned(p.field(6), v) ? static_cast<uint8_t>(v) : 0;
+  out.satellites = parseUnsigned(p.field(7), v) ? static_cast<uint8_t>(v) : 0;
+  out.hdop = optionalFixed16(p.field(8), 2);
+  int32_t alt;
+  out.altitude = parseFixed(p.field(9), 1, alt) ? alt : 0;
+  return true;
+}
+
+// $GPRMC,time,status,lat,N,lon,E,speed,course,date,magvar,E[,mode]
+bool decodeRmc(const NmeaParser& p, RmcData& out) {
+  if (p.type() != SentenceType::RMC || p.fieldCount() < 10) return false;
+  if (!parseTime(p.field(1), out.time)) return false;
+
+  const NmeaField status = p.field(2);
+  out.valid = status.len == 1 && status.data[0] == 'A';
+  out.hasPosition = parseAngle(p.field(3), p.field(4), out.latitude) &&
+                    parseAngle(p.field(5), p.field(6), out.longitude);
+  if (!out.hasPosition) {
+    out.latitude = 0;
+    out.longitude = 0;
+  }
+
+  const uint16_t speed = optionalFixed16(p.field(7), 2);
+  out.speed = speed == kNoValue16 ? 0 : speed;
+  out.course = optionalFixed16(p.field(8), 2);
+  if (!parseDate(p.field(9), out.date)) {
+    out.date.day = out.date.month = out.date.year = 0;
+  }
+  return true;
+}
+
+// $GPGSA,mode,fix,prn1..prn12,pdop,hdop,vdop[,system]
+bool decodeGsa(const NmeaParser& p, GsaData& out) {
+  if (p.type() != SentenceType::GSA || p.fieldCount() < 18) return false;
+  const NmeaField mode = p.field(1);
+  out.mode = mode.len == 1 ? mode.data[0] : '\0';
+  uint32_t v;
+  if (!parseUnsigned(p.field(2), v)) return false;
+  out.fixType = static_cast<uint8_t>(v);
+
+  out.prnCount = 0;
+  for (uint8_t i = 0; i < 12; ++i) {
+    if (parseUnsigned(p.field(3 + i), v)) {
+      out.prns[out.prnCount++] = static_cast<uint8_t>(v);
+    }
+  }
+  out.pdop = optionalFixed16(p.field(15), 2);
+  out.hdop = optionalFixed16(p.field(16), 2);
+  out.vdop = optionalFixed16(p.field(17), 2);
+  return true;
+}
+
+// $GPGSV,total,number,inview{,prn,elev,azim,snr}x(1..4)[,signal]
+bool decodeGsv(const NmeaParser& p, GsvData& out) {
+  if (p.type() != SentenceType::GSV || p.fieldCount() < 4) return false;
+  uint32_t v;
+  if (!parseUnsigned(p.field(1), v)) return false;
+  out.totalMessages = static_cast<uint8_t>(v);
+  if (!parseUnsigned(p.field(2), v)) return false;
+  out.messageNumber = static_cast<uint8_t>(v);
+  if (!parseUnsigned(p.field(3), v)) return false;
+  out.satellitesInView = static_cast<uint8_t>(v);
+
+  out.count = 0;
+  for (uint8_t base = 4; base + 3 < p.fieldCount() && out.count < 4;
+       base += 4) {
+    GsvSatellite& s = out.sats[out.count];
+    if (!parseUnsigned(p.field(base), v)) continue;
+    s.prn = static_cast<uint8_t>(v);
+    s.elevation = parseUnsigned(p.field(base + 1), v) ? static_cast<int8_t>(v)
+                                                       : 0;
+    s.azimuth =
+        parseUnsigned(p.field(base + 2), v) ? static_cast<uint16_t>(v) : 0;
+    s.snr = parseUnsigned(p.field(base + 3), v) ? static_cast<int8_t>(v) : -1;
+    ++out.count;
+  }
+  return true;
+}
+
+}  // namespace vx8
@@ -0,0 +1,114 @@
+// Typed decoders for the sentences the bridge cares about.
+//
+// All values are integers scaled to the resolution NMEA transmits, so no
+// soft-float is pulled in on AVR:
+//   angles    1e-5 arc-minutes, signed (north/east positive); ddmm.mmmmm fits
+//             in int32 for the full +/-180 degree range
+//   speed     centi-knots
+//   course    centi-degrees
+//   DOP       hundredths
+//   altitude  decimetres
+// Decoders read straight out of the parser's buffer and return false when a
+// required field is missing or malformed. They are meant to run from the main
+// loop, not from NmeaParser::feed().
+
+#ifndef VX8_NMEA_SENTENCES_H
+#define VX8_NMEA_SENTENCES_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+
+namespace vx8 {
+
+struct UtcTime {
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint8_t centisecond;
+
+  // Seconds since midnight, handy for detecting a new epoch.
+  uint32_t secondOfDay() const {
+    return static_cast<uint32_t>(hour) * 3600U + minute * 60U + second;
+  }
+};
+
+struct UtcDate {
+  uint8_t day;
+  uint8_t month;
+  uint8_t year;  // two digits, as transmitted
+};
+
+struct GgaData {
+  UtcTime time;
+  int32_t latitude;   // 1e-5 arc-minutes
+  int32_t longitude;  // 1e-5 arc-minutes
+  uint8_t quality;    // 0 = no fix, 1 = GPS, 2 = DGPS, ...
+  uint8_t satellites;
+  uint16_t hdop;      // hundredths, 0xFFFF when absent
+  int32_t altitude;   // decimetres above mean sea level
+  bool hasPosition;
+};
+
+struct RmcData {
+  UtcTime time;
+  UtcDate date;     // all zero when absent or malformed
+  int32_t latitude;
+  int32_t longitude;
+  uint16_t speed;   // centi-knots
+  uint16_t course;  // centi-degrees, 0xFFFF when absent
+  bool valid;       // status field 'A'
+  bool hasPosition;
+};
+
+struct GsaData {
+  char mode;        // 'A' automatic, 'M' manual
+  uint8_t fixType;  // 1 = none, 2 = 2D, 3 = 3D
+  uint8_t prnCount;
+  uint8_t prns[12];
+  uint16_t pdop;
+  uint16_t hdop;
+  uint16_t vdop;
+};
+
+struct GsvSatellite {
+  uint8_t prn;
+  int8_t elevation;  // degrees
+  uint16_t azimuth;  // degrees
+  int8_t snr;        // dB-Hz, -1 when not tracked
+};
+
+struct GsvData {
+  uint8_t totalMessages;
+  uint8_t messageNumber;
+  uint8_t satellitesInView;
+  uint8_t count;  // entries filled in sats[]
+  GsvSatellite sats[4];
+};
+
+const uint16_t kNoValue16 = 0xFFFF;
+
+// Parses a decimal field, optionally negative, with up to `decimals`
+// fractional digits and returns it scaled by 10^decimals. Extra fractional
+// digits are truncated. Fails on a field without digits or one that does not
+// fit in int32_t once scaled.
+bool parseFixed(const NmeaField& f, uint8_t decimals, int32_t& out);
+bool parseUnsigned(const NmeaField& f, uint32_t& out);
+
+// Parses "ddmm.mmmmm" / "dddmm.mmmmm" plus its N/S/E/W field into signed
+// 1e-5 arc-minutes.
+bool parseAngle(const NmeaField& value, const NmeaField& hemisphere,
+                int32_t& out);
+
+bool parseTime(const NmeaField& f, UtcTime& out);
+// "ddmmyy"; fails on day 0 or above 31 and month 0 or above 12.
+bool parseDate(const NmeaField& f, UtcDate& out);
+
+bool decodeGga(const NmeaParser& p, GgaData& out);
+bool decodeRmc(const NmeaParser& p, RmcData& out);
+bool decodeGsa(const NmeaParser& p, GsaData& out);
+bool decodeGsv(const NmeaParser& p, GsvData& out);
+
+}  // namespace vx8
+
+#endif  // VX8_NMEA_SENTENCES_H
@@ -0,0 +1,169 @@
+#include "output_profile.h"
+
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+static_assert(VX8_SENTENCE_GGA == 1 << static_cast<uint8_t>(SentenceType::GGA),
+              "VX8_SENTENCE_GGA out of step with SentenceType");
+static_assert(VX8_SENTENCE_RMC == 1 << static_cast<uint8_t>(SentenceType::RMC),
+              "VX8_SENTENCE_RMC out of step with SentenceType");
+static_assert(VX8_SENTENCE_GSA == 1 << static_cast<uint8_t>(SentenceType::GSA),
+              "VX8_SENTENCE_GSA out of step with SentenceType");
+static_assert(VX8_SENTENCE_GSV == 1 << static_cast<uint8_t>(SentenceType::GSV),
+              "VX8_SENTENCE_GSV out of step with SentenceType");
+
+namespace {
+
+// Field counts (including the address field) of the NMEA 4.1 forms whose
+// last field is the one stripped.
+const uint8_t kRmcNavStatusField = 13;
+const uint8_t kGsaSystemIdField = 18;
+
+bool isTimed(SentenceType t) {
+  return t == SentenceType::GGA || t == SentenceType::RMC;
+}
+
+}  // namespace
+
+ProfileConfig ProfileConfig::defaults() {
+  ProfileConfig c;
+  c.sentences = VX8_PROFILE_SENTENCES;
+  c.gnToGp = VX8_PROFILE_GN_TO_GP != 0;
+  c.oneHz = VX8_PROFILE_ONE_HZ != 0;
+  c.maxGsvSatellites = VX8_PROFILE_MAX_GSV_SATS;
+  c.stripNmea41 = VX8_PROFILE_STRIP_NMEA41 != 0;
+  c.timelessDivisor = 10;
+  return c;
+}
+
+OutputProfile::OutputProfile() : OutputProfile(ProfileConfig::defaults()) {}
+
+OutputProfile::OutputProfile(const ProfileConfig& config)
+    : config_(config),
+      epochKey_(0),
+      lastSecond_(0),
+      haveEpoch_(false),
+      haveSecond_(false),
+      epochAccepted_(true),
+      gsaSent_(false),
+      timelessLeader_(SentenceType::Unknown),
+      timelessEpochs_(0) {}
+
+bool OutputProfile::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<OutputProfile*>(ctx)->apply(p, raw);
+}
+
+bool OutputProfile::apply(const NmeaParser& p, SentenceView& raw) {
+  const SentenceType type = p.type();
+  if (!(config_.sentences & (1 << static_cast<uint8_t>(type)))) return false;
+  const Talker talker = p.talker();
+  if (talker != Talker::GP && talker != Talker::GN) return false;
+
+  const bool accepted = trackEpoch(p);
+  if (config_.oneHz && !accepted) return false;
+
+  bool edited = false;
+  switch (type) {
+    case SentenceType::GSA:
+      if (gsaSent_) return false;
+      gsaSent_ = true;
+      if (config_.stripNmea41 && p.fieldCount() > kGsaSystemIdField) {
+        edited |= raw.truncateAt(p.fieldOffset(kGsaSystemIdField) - 1);
+      }
+      break;
+    case SentenceType::GSV:
+      if (!capGsv(p, raw, edited)) return false;
+      break;
+    case SentenceType::RMC:
+      if (config_.stripNmea41 && p.fieldCount() > kRmcNavStatusField) {
+        edited |= raw.truncateAt(p.fieldOffset(kRmcNavStatusField) - 1);
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (talker == Talker::GN && config_.gnToGp) {
+    raw.setTalker('G', 'P');
+    edited = true;
+  }
+  if (edited) raw.updateChecksum();
+  return true;
+}
+
+// Epochs are identified by the UTC time in GGA/RMC; GSA and GSV carry no
+// time and belong to whichever epoch is open. Returns whether the current
+// sentence's epoch is the first one of its second.
+bool OutputProfile::trackEpoch(const NmeaParser& p) {
+  const SentenceType type = p.type();
+  UtcTime t;
+  if (!isTimed(type)) return epochAccepted_;
+
+  if (!parseTime(p.field(1), t)) {
+    // No time yet: each repeat of the first timed sentence type starts an
+    // epoch, and one in timelessDivisor is forwarded.
+    if (timelessLeader_ == SentenceType::Unknown) timelessLeader_ = type;
+    if (type == timelessLeader_) {
+      epochAccepted_ = config_.timelessDivisor <= 1 ||
+                       timelessEpochs_ % config_.timelessDivisor == 0;
+      ++timelessEpochs_;
+      gsaSent_ = false;
+      haveEpoch_ = false;
+    }
+    return epochAccepted_;
+  }
+
+  const uint32_t second = t.secondOfDay();
+  const uint32_t key = second * 100 + t.centisecond;
+  if (haveEpoch_ && key == epochKey_) return epochAccepted_;
+
+  epochKey_ = key;
+  haveEpoch_ = true;
+  gsaSent_ = false;
+  epochAccepted_ = !haveSecond_ || second != lastSecond_;
+  if (epochAccepted_) {
+    lastSecond_ = second;
+    haveSecond_ = true;
+  }
+  return epochAccepted_;
+}
+
+// $GPGSV,total,number,inview{,prn,elev,azim,snr}[,signal]
+bool OutputProfile::capGsv(const NmeaParser& p, SentenceView& raw,
+                           bool& edited) {
+  uint32_t total, number, inView;
+  if (!parseUnsigned(p.field(1), total) || !parseUnsigned(p.field(2), number) ||
+      !parseUnsigned(p.field(3), inView)) {
+    return false;
+  }
+  const uint8_t count = p.fieldCount();
+  const bool hasSignalId = count > 4 && (count - 4) % 4 == 1;
+
+  const uint8_t maxSats = config_.maxGsvSatellites;
+  if (maxSats == 0 || inView <= maxSats) {
+    if (config_.stripNmea41 && hasSignalId) {
+      edited |= raw.truncateAt(p.fieldOffset(count - 1) - 1);
+    }
+    return true;
+  }
+
+  const uint8_t maxMessages = static_cast<uint8_t>((maxSats + 3) / 4);
+  if (number > maxMessages) return false;
+  if (total > maxMessages) {
+    edited |= raw.writeUnsigned(p.fieldOffset(1), p.field(1).len, maxMessages);
+  }
+  edited |= raw.writeUnsigned(p.fieldOffset(3), p.field(3).len, maxSats);
+
+  // The last kept message may carry satellites beyond the cap.
+  const uint8_t keep = static_cast<uint8_t>(maxSats - 4 * (number - 1));
+  const uint8_t firstDropped = static_cast<uint8_t>(4 + 4 * keep);
+  if (keep < 4 && firstDropped < count) {
+    edited |= raw.truncateAt(p.fieldOffset(firstDropped) - 1);
+  } else if (config_.stripNmea41 && hasSignalId) {
+    edited |= raw.truncateAt(p.fieldOffset(count - 1) - 1);
+  }
+  return true;
+}
+
+}  // namespace vx8
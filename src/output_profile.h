@@ -0,0 +1,72 @@
+// What the VX-8R gets to see.
+//
+// Modern u-blox and MediaTek modules talk "GN", report several
+// constellations and update at 5-10 Hz. The radio understands GPS-only
+// NMEA at about 1 Hz, so the profile sits in the bridge's filter hook and,
+// for every checksum-valid sentence:
+//   - drops sentence types outside the configured set and anything from a
+//     non-GPS talker (GLGSV, GAGSV, ...),
+//   - keeps only the first epoch of each UTC second, and the first GSA of an
+//     epoch (multi-GNSS modules send one per constellation),
+//   - caps GSV at a satellite count, dropping surplus messages and rewriting
+//     the message and satellite totals,
+//   - rewrites the GN talker to GP and strips NMEA 4.1 trailing fields,
+// then recomputes the checksum. All edits are made in place in the receive
+// buffer. Defaults come from vx8_config.h.
+
+#ifndef VX8_OUTPUT_PROFILE_H
+#define VX8_OUTPUT_PROFILE_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+struct ProfileConfig {
+  uint8_t sentences;         // VX8_SENTENCE_* mask
+  bool gnToGp;
+  bool oneHz;
+  uint8_t maxGsvSatellites;  // 0 = no cap
+  bool stripNmea41;
+  // Before the module knows UTC time there is no second to decimate on;
+  // forward one epoch in this many instead.
+  uint8_t timelessDivisor;
+
+  static ProfileConfig defaults();
+};
+
+class OutputProfile {
+ public:
+  OutputProfile();
+  explicit OutputProfile(const ProfileConfig& config);
+
+  // Returns true if the sentence should go to the radio, after rewriting
+  // `raw` as needed.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+
+  // Bridge::SentenceFilter adaptor; `ctx` is the OutputProfile.
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  const ProfileConfig& config() const { return config_; }
+
+ private:
+  bool trackEpoch(const NmeaParser& p);
+  bool capGsv(const NmeaParser& p, SentenceView& raw, bool& edited);
+
+  ProfileConfig config_;
+  uint32_t epochKey_;    // centiseconds of day of the current epoch
+  uint32_t lastSecond_;  // UTC second of the last accepted epoch
+  bool haveEpoch_;
+  bool haveSecond_;
+  bool epochAccepted_;
+  bool gsaSent_;
+  SentenceType timelessLeader_;
+  uint8_t timelessEpochs_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_OUTPUT_PROFILE_H
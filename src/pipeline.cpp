@@ -0,0 +1,38 @@
+#include "pipeline.h"
+
+namespace vx8 {
+
+Pipeline::Pipeline() : power_(GpsModule::Unknown) {}
+
+void Pipeline::begin(const PipelineStages& stages) {
+  filters_.add(&Monitor::filter, &monitor_);  // must see queries first
+#if VX8_FIX_LOG
+  filters_.add(&FixLogger::filter, &logger_);  // ahead of the profile
+#endif
+  if (stages.profile) filters_.add(&OutputProfile::filter, &profile_);
+#if VX8_MOTION_FILTER
+  if (stages.motion) filters_.add(&MotionFilter::filter, &motion_);
+#endif
+  filters_.add(&PowerManager::filter, &power_);
+#if VX8_PPS_SYNC
+  filters_.add(&PpsSync::filter, &pps_);  // holds what the others produced
+#endif
+  bridge_.setFilter(&FilterChain::filter, &filters_);
+}
+
+SleepRequest Pipeline::update(uint32_t now) {
+#if VX8_PPS_SYNC
+  pps_.update(now, bridge_);  // ahead of reports, which can wait
+#endif
+  monitor_.update(now, bridge_);
+#if VX8_FIX_LOG
+  logger_.update(now, bridge_);
+#endif
+  SleepRequest request = power_.update(now, bridge_);
+#if VX8_PPS_SYNC
+  request = pps_.limit(request, now);
+#endif
+  return request;
+}
+
+}  // namespace vx8
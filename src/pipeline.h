@@ -0,0 +1,94 @@
+// The firmware without the board: the bridge, its filter stages in the
+// order they run, and the main loop's work after Bridge::poll(). Firmware
+// (firmware.h) runs it on a board and tools/replay.cpp on a simulated
+// clock, so a replay forwards exactly what the device would.
+//
+// Stages, in order: the diagnostics monitor (it must see queries first),
+// the track log (VX8_FIX_LOG), the output profile, the motion filter
+// (VX8_MOTION_FILTER), the power manager, and the PPS alignment
+// (VX8_PPS_SYNC), which holds what the others produced.
+
+#ifndef VX8_PIPELINE_H
+#define VX8_PIPELINE_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "filter_chain.h"
+#include "fix_logger.h"
+#include "monitor.h"
+#include "motion_filter.h"
+#include "output_profile.h"
+#include "power_manager.h"
+#include "pps_sync.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+// Optional stages, for replaying without them; the firmware runs defaults().
+// A stage left out of the build stays out whatever is asked for here.
+struct PipelineStages {
+  bool profile;
+  bool motion;
+
+  static PipelineStages defaults() {
+    PipelineStages s;
+    s.profile = true;
+    s.motion = VX8_MOTION_FILTER != 0;
+    return s;
+  }
+};
+
+class Pipeline {
+ public:
+  Pipeline();
+
+  // Builds the filter chain and hands it to the bridge. Once only.
+  void begin(const PipelineStages& stages = PipelineStages::defaults());
+
+  // Main loop, after Bridge::poll(): reports, held fixes, the track log and
+  // module power. Returns how the board may sleep until the next pass.
+  SleepRequest update(uint32_t nowMs);
+
+  // Reports, held fixes or log export still to be handed to the bridge.
+  bool outputPending() const {
+#if VX8_PPS_SYNC
+    if (pps_.holding()) return true;
+#endif
+#if VX8_FIX_LOG
+    if (logger_.exporting()) return true;
+#endif
+    return monitor_.reportPending();
+  }
+
+  Bridge& bridge() { return bridge_; }
+  Monitor& monitor() { return monitor_; }
+  const Monitor& monitor() const { return monitor_; }
+  PowerManager& power() { return power_; }
+#if VX8_FIX_LOG
+  FixLogger& logger() { return logger_; }
+#endif
+#if VX8_PPS_SYNC
+  PpsSync& pps() { return pps_; }
+#endif
+
+ private:
+  Bridge bridge_;
+  Monitor monitor_;
+  OutputProfile profile_;
+#if VX8_MOTION_FILTER
+  MotionFilter motion_;
+#endif
+  PowerManager power_;
+#if VX8_FIX_LOG
+  FixLogger logger_;
+#endif
+#if VX8_PPS_SYNC
+  PpsSync pps_;
+#endif
+  FilterChain filters_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_PIPELINE_H
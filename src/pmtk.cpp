@@ -0,0 +1,64 @@
+#include "pmtk.h"
+
+#include "nmea_sentences.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+namespace pmtk {
+
+namespace {
+
+uint8_t copy(const char* s, char* out) {
+  uint8_t n = 0;
+  while (s[n]) {
+    out[n] = s[n];
+    ++n;
+  }
+  return n;
+}
+
+}  // namespace
+
+uint8_t test(char* out) { return finishSentence(out, copy("$PMTK000", out)); }
+
+uint8_t setOutput(uint8_t sentenceMask, char* out) {
+  // Field order: GLL, RMC, VTG, GGA, GSA, GSV, then 13 reserved/vendor
+  // sentences that are always turned off.
+  const uint8_t order[6] = {0, VX8_SENTENCE_RMC, 0, VX8_SENTENCE_GGA,
+                            VX8_SENTENCE_GSA, VX8_SENTENCE_GSV};
+  uint8_t n = copy("$PMTK314", out);
+  for (uint8_t i = 0; i < 19; ++i) {
+    out[n++] = ',';
+    const bool on = i < 6 && order[i] && (sentenceMask & order[i]);
+    out[n++] = on ? '1' : '0';
+  }
+  return finishSentence(out, n);
+}
+
+uint8_t setFixInterval(uint16_t ms, char* out) {
+  uint8_t n = copy("$PMTK220,", out);
+  n = static_cast<uint8_t>(n + formatUnsigned(ms, out + n));
+  return finishSentence(out, n);
+}
+
+uint8_t setBaud(uint32_t baud, char* out) {
+  uint8_t n = copy("$PMTK251,", out);
+  n = static_cast<uint8_t>(n + formatUnsigned(baud, out + n));
+  return finishSentence(out, n);
+}
+
+bool parseAck(const NmeaParser& p, uint16_t& command, uint8_t& flag) {
+  if (p.type() != SentenceType::Proprietary || !p.field(0).equals("PMTK001")) {
+    return false;
+  }
+  uint32_t cmd, f;
+  if (!parseUnsigned(p.field(1), cmd) || !parseUnsigned(p.field(2), f)) {
+    return false;
+  }
+  command = static_cast<uint16_t>(cmd);
+  flag = static_cast<uint8_t>(f);
+  return true;
+}
+
+}  // namespace pmtk
+}  // namespace vx8
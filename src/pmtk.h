@@ -0,0 +1,50 @@
+// MediaTek PMTK command sentences (MT3329/MT3339 and relatives).
+//
+// Builders write a complete "$PMTKnnn,...*hh\r\n" sentence into `out` and
+// return its length; kMaxSentence bytes always suffice. Acknowledgements
+// ("$PMTK001,cmd,flag") are ordinary NMEA and are read back through
+// NmeaParser.
+
+#ifndef VX8_PMTK_H
+#define VX8_PMTK_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+
+namespace vx8 {
+namespace pmtk {
+
+const uint8_t kMaxSentence = 64;
+
+const uint16_t kCmdTest = 0;
+const uint16_t kCmdSetBaud = 251;
+const uint16_t kCmdFixInterval = 220;
+const uint16_t kCmdOutput = 314;
+
+// PMTK001 flag values.
+const uint8_t kAckInvalid = 0;
+const uint8_t kAckUnsupported = 1;
+const uint8_t kAckFailed = 2;
+const uint8_t kAckOk = 3;
+
+// $PMTK000: test packet, answered with $PMTK001,0,3.
+uint8_t test(char* out);
+
+// $PMTK314: one output per fix for each sentence in `sentenceMask`
+// (VX8_SENTENCE_* bits), everything else off.
+uint8_t setOutput(uint8_t sentenceMask, char* out);
+
+// $PMTK220: position fix interval in milliseconds.
+uint8_t setFixInterval(uint16_t ms, char* out);
+
+// $PMTK251: UART baud rate. Not acknowledged; takes effect immediately.
+uint8_t setBaud(uint32_t baud, char* out);
+
+// Reads a $PMTK001 acknowledgement.
+bool parseAck(const NmeaParser& p, uint16_t& command, uint8_t& flag);
+
+}  // namespace pmtk
+}  // namespace vx8
+
+#endif  // VX8_PMTK_H
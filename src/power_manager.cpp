@@ -0,0 +1,174 @@
+#include "power_manager.h"
+
+#include "nmea_sentences.h"
+#include "ubx.h"
+
+namespace vx8 {
+
+static_assert(Bridge::kMaxInject >= ubx::kMaxEncodedFrame + 10,
+              "CFG-PM2 and CFG-RXM must fit one injection");
+
+namespace {
+
+// Locked bursts before a backed-off guard interval is halved again.
+const uint8_t kRelaxBursts = 60;
+
+uint32_t absDiff(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+}  // namespace
+
+PowerConfig PowerConfig::defaults() {
+  PowerConfig c;
+  c.periodMs = VX8_GPS_FIX_INTERVAL_MS;
+  c.quietMs = 20;
+  c.jitterMs = 30;
+  c.lockBursts = 3;
+  c.guardMs = VX8_POWER_GUARD_MS;
+  c.maxGuardMs = 400;
+  c.minSleepMs = 32;
+  c.powerDown = VX8_POWER_DOWN != 0;
+  c.stableFixes = VX8_POWER_STABLE_FIXES;
+  c.maxHdop = 200;
+  return c;
+}
+
+PowerManager::PowerManager(GpsModule module)
+    : PowerManager(module, PowerConfig::defaults()) {}
+
+PowerManager::PowerManager(GpsModule module, const PowerConfig& config)
+    : config_(config),
+      module_(module),
+      port_(),
+      hasPort_(false),
+      lastBytesIn_(0),
+      lastErrors_(0),
+      lastOverruns_(0),
+      lastRx_(0),
+      burstStart_(0),
+      nextBurst_(0),
+      wakeAt_(0),
+      guard_(config.guardMs),
+      earlyBursts_(0),
+      evenBursts_(0),
+      cleanBursts_(0),
+      haveBurst_(false),
+      inBurst_(false),
+      locked_(false),
+      waking_(false),
+      goodFixes_(0),
+      moduleSaving_(false),
+      pm2Sent_(false) {}
+
+bool PowerManager::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<PowerManager*>(ctx)->apply(p, raw);
+}
+
+bool PowerManager::apply(const NmeaParser& p, SentenceView&) {
+  if (p.type() == SentenceType::GGA) {
+    GgaData g;
+    if (decodeGga(p, g) && g.quality > 0 && g.hdop <= config_.maxHdop) {
+      if (goodFixes_ < 0xFF) ++goodFixes_;
+    } else {
+      goodFixes_ = 0;
+    }
+  } else if (p.type() == SentenceType::RMC) {
+    RmcData r;
+    if (decodeRmc(p, r) && !r.valid) goodFixes_ = 0;
+  }
+  return true;
+}
+
+SleepRequest PowerManager::update(uint32_t nowMs, Bridge& bridge) {
+  const BridgeStats& s = bridge.stats();
+  const bool received = s.bytesIn != lastBytesIn_;
+  // A burst that starts right after a power-down (or wakes the board before
+  // it was due) was already under way while the UART was stopped.
+  const int32_t sinceWake = static_cast<int32_t>(nowMs - wakeAt_);
+  const bool cutShort = waking_ && received && sinceWake < config_.quietMs;
+  if (received || sinceWake >= config_.quietMs) waking_ = false;
+  const bool lost = s.parseErrors != lastErrors_ ||
+                    s.rxOverruns != lastOverruns_ || cutShort;
+  lastBytesIn_ = s.bytesIn;
+  lastErrors_ = s.parseErrors;
+  lastOverruns_ = s.rxOverruns;
+
+  if (lost && locked_) {
+    ++earlyBursts_;
+    const uint16_t doubled = static_cast<uint16_t>(guard_ * 2);
+    guard_ = doubled < config_.maxGuardMs ? doubled : config_.maxGuardMs;
+    unlock();
+  }
+  if (received) {
+    if (!inBurst_) {
+      inBurst_ = true;
+      onBurstStart(nowMs);
+    }
+    lastRx_ = nowMs;
+  } else if (inBurst_ && nowMs - lastRx_ >= config_.quietMs) {
+    inBurst_ = false;
+  }
+
+  updateModule(bridge);
+
+  SleepRequest r;
+  r.mode = SleepMode::Idle;
+  r.ms = 0;
+  if (!config_.powerDown || !locked_ || inBurst_ || bridge.txPending()) {
+    return r;
+  }
+  const int32_t until = static_cast<int32_t>(nextBurst_ - guard_ - nowMs);
+  if (until < config_.minSleepMs) return r;
+  r.mode = SleepMode::PowerDown;
+  r.ms = until > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(until);
+  waking_ = true;
+  wakeAt_ = nowMs + r.ms;
+  return r;
+}
+
+void PowerManager::onBurstStart(uint32_t nowMs) {
+  if (haveBurst_) {
+    if (absDiff(nowMs - burstStart_, config_.periodMs) <= config_.jitterMs) {
+      if (evenBursts_ < 0xFF) ++evenBursts_;
+    } else {
+      unlock();
+    }
+    if (!locked_ && evenBursts_ >= config_.lockBursts) locked_ = true;
+    if (locked_ && ++cleanBursts_ >= kRelaxBursts) {
+      cleanBursts_ = 0;
+      const uint16_t halved = static_cast<uint16_t>(guard_ / 2);
+      guard_ = halved > config_.guardMs ? halved : config_.guardMs;
+    }
+  }
+  haveBurst_ = true;
+  burstStart_ = nowMs;
+  nextBurst_ = nowMs + config_.periodMs;
+}
+
+void PowerManager::unlock() {
+  locked_ = false;
+  evenBursts_ = 0;
+  cleanBursts_ = 0;
+}
+
+void PowerManager::updateModule(Bridge& bridge) {
+  if (module_ != GpsModule::Ublox || config_.stableFixes == 0 ||
+      (!hasPort_ && bridge.injectPending())) {
+    return;
+  }
+  const bool want = goodFixes_ >= config_.stableFixes;
+  if (want == moduleSaving_) return;
+
+  uint8_t buf[Bridge::kMaxInject];
+  uint8_t len = 0;
+  if (want && !pm2Sent_) len = ubx::cfgPm2(config_.periodMs, buf);
+  len = static_cast<uint8_t>(len + ubx::cfgRxm(want, buf + len));
+  if (hasPort_) {
+    port_.write(port_.ctx, buf, len);
+  } else if (!bridge.inject(buf, len)) {
+    return;
+  }
+  moduleSaving_ = want;
+  if (want) pm2Sent_ = true;
+}
+
+}  // namespace vx8
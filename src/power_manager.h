@@ -0,0 +1,127 @@
+// Low-power mode: MCU sleep between the module's output bursts, and the
+// module's own power save while the fix is good.
+//
+// At 1 Hz the GPS sends one burst of sentences per second and the bridge has
+// nothing to do in between. The power manager runs in the main loop after
+// Bridge::poll() and tells the board how to sleep until the next call:
+//   Idle       the UART keeps running and any interrupt wakes the MCU. Always
+//              safe; used while bytes arrive or output is pending.
+//   PowerDown  clocks stop, so a byte arriving now would be lost. Only
+//              requested for the quiet gap before the next burst, once the
+//              last few bursts all started one period apart, and ending a
+//              guard interval before the next one is due.
+// If input is lost anyway (a parse error or overrun, or a burst that is
+// already under way on waking up: it came early), the prediction is dropped,
+// the guard interval doubles and power-down waits until the bursts line up
+// again; at most one epoch is affected.
+//
+// The manager is also a filter stage (it never drops anything): after
+// several consecutive good fixes it injects UBX CFG-PM2 + CFG-RXM to put a
+// u-blox module into cyclic tracking at the fix interval, which keeps 1 Hz
+// output, and switches it back to continuous tracking when the fix is lost.
+// MediaTek periodic and AlwaysLocate modes stretch the output interval while
+// the module sleeps, so MediaTek modules are left in full power.
+//
+// Time is whatever millisecond clock the caller uses, as long as it keeps
+// counting through power-down (see avr_power.h), so tests drive it with a
+// simulated clock.
+
+#ifndef VX8_POWER_MANAGER_H
+#define VX8_POWER_MANAGER_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "module_config.h"
+#include "nmea_parser.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+enum class SleepMode : uint8_t { Idle, PowerDown };
+
+struct SleepRequest {
+  SleepMode mode;
+  uint16_t ms;  // PowerDown: how long; the board may wake earlier
+};
+
+struct PowerConfig {
+  uint16_t periodMs;     // expected burst period (the fix interval)
+  uint16_t quietMs;      // silence that ends a burst
+  uint16_t jitterMs;     // allowed deviation of a burst from the period
+  uint8_t lockBursts;    // evenly spaced bursts before powering down
+  uint16_t guardMs;      // wake this early before the next burst
+  uint16_t maxGuardMs;   // cap for the backed-off guard interval
+  uint16_t minSleepMs;   // shorter power-downs are not worth it
+  bool powerDown;        // false: never more than Idle
+  uint8_t stableFixes;   // good fixes before module power save; 0 = never
+  uint16_t maxHdop;      // hundredths; worse fixes are not good
+
+  static PowerConfig defaults();
+};
+
+class PowerManager {
+ public:
+  explicit PowerManager(GpsModule module);
+  PowerManager(GpsModule module, const PowerConfig& config);
+
+  // Once the module configurator has identified the module.
+  void setModule(GpsModule module) { module_ = module; }
+  // Boards where the module has its own UART (board.h): send module
+  // commands there rather than injecting them into the radio output.
+  void setModulePort(const ConfigPort& port) {
+    port_ = port;
+    hasPort_ = true;
+  }
+
+  // Main loop, after Bridge::poll(). May inject module commands.
+  SleepRequest update(uint32_t nowMs, Bridge& bridge);
+
+  // Filter stage watching fix quality; always returns true.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  // Bursts are evenly spaced and power-down may be requested.
+  bool locked() const { return locked_; }
+  bool moduleSaving() const { return moduleSaving_; }
+  uint16_t guardMs() const { return guard_; }
+  // Times input was lost while locked.
+  uint16_t earlyBursts() const { return earlyBursts_; }
+
+  const PowerConfig& config() const { return config_; }
+
+ private:
+  void onBurstStart(uint32_t nowMs);
+  void unlock();
+  void updateModule(Bridge& bridge);
+
+  PowerConfig config_;
+  GpsModule module_;
+  ConfigPort port_;
+  bool hasPort_;
+
+  uint32_t lastBytesIn_;
+  uint16_t lastErrors_;
+  uint16_t lastOverruns_;
+  uint32_t lastRx_;
+  uint32_t burstStart_;
+  uint32_t nextBurst_;
+  uint32_t wakeAt_;
+  uint16_t guard_;
+  uint16_t earlyBursts_;
+  uint8_t evenBursts_;
+  uint8_t cleanBursts_;
+  bool haveBurst_;
+  bool inBurst_;
+  bool locked_;
+  bool waking_;  // powered down, no burst seen since
+
+  uint8_t goodFixes_;
+  bool moduleSaving_;
+  bool pm2Sent_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_POWER_MANAGER_H
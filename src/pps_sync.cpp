@@ -0,0 +1,151 @@
+#include "pps_sync.h"
+
+#include "nmea_sentences.h"
+
+namespace vx8 {
+
+PpsConfig PpsConfig::defaults() {
+  PpsConfig c;
+  c.sentences = VX8_SENTENCE_GGA | VX8_SENTENCE_RMC;
+  c.timeoutMs = 1100;
+  c.lostMs = 2500;
+  c.guardMs = VX8_POWER_GUARD_MS;
+  return c;
+}
+
+PpsSync::PpsSync() : PpsSync(PpsConfig::defaults()) {}
+
+PpsSync::PpsSync(const PpsConfig& config)
+    : config_(config),
+      edges_(0),
+      seenEdges_(0),
+      serial_(0),
+      lastEdgeMs_(0),
+      haveEdge_(false),
+      synced_(false),
+      aligned_(0),
+      late_(0) {
+  for (uint8_t i = 0; i < kSlots; ++i) slots_[i].state = SlotState::Empty;
+}
+
+bool PpsSync::filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+  return static_cast<PpsSync*>(ctx)->apply(p, raw);
+}
+
+bool PpsSync::apply(const NmeaParser& p, SentenceView& raw) {
+  const uint8_t bit =
+      static_cast<uint8_t>(1u << static_cast<uint8_t>(p.type()));
+  if (!synced_ || !(bit & config_.sentences & (VX8_SENTENCE_GGA |
+                                                VX8_SENTENCE_RMC))) {
+    return true;
+  }
+  UtcTime t;
+  if (!parseTime(p.field(1), t) || t.centisecond != 0) return true;
+
+  Slot* slot = slotFor(t.secondOfDay(), edges_);
+  if (!slot || (slot->held & bit) ||
+      slot->length + raw.length() + 2 > kSlotSize) {
+    return true;
+  }
+  for (uint8_t i = 0; i < raw.length(); ++i) {
+    slot->data[slot->length++] = static_cast<uint8_t>(raw.get(i));
+  }
+  slot->data[slot->length++] = '\r';
+  slot->data[slot->length++] = '\n';
+  slot->held = static_cast<uint8_t>(slot->held | bit);
+  return false;
+}
+
+// The slot collecting `second`, or a free one. A sentence that comes after
+// the edge which already made its slot due still joins it, so a slow module
+// does not split an epoch.
+PpsSync::Slot* PpsSync::slotFor(uint32_t second, uint8_t edges) {
+  Slot* free = 0;
+  for (uint8_t i = 0; i < kSlots; ++i) {
+    Slot& s = slots_[i];
+    if (s.state == SlotState::Holding && s.second == second) return &s;
+    if (s.state == SlotState::Empty && !free) free = &s;
+  }
+  if (free) {
+    free->state = SlotState::Holding;
+    free->length = 0;
+    free->held = 0;
+    free->edges = edges;
+    free->serial = serial_++;
+    free->second = second;
+    free->stamped = false;
+  }
+  return free;
+}
+
+void PpsSync::update(uint32_t nowMs, Bridge& bridge) {
+  const uint8_t edges = edges_;
+  if (edges != seenEdges_) {
+    seenEdges_ = edges;
+    lastEdgeMs_ = nowMs;
+    haveEdge_ = true;
+  }
+  synced_ = haveEdge_ && nowMs - lastEdgeMs_ < config_.lostMs;
+
+  // Only one injection is in flight at a time, so a slot being sent is done
+  // as soon as the bridge has none pending.
+  for (uint8_t i = 0; i < kSlots; ++i) {
+    Slot& s = slots_[i];
+    if (s.state == SlotState::Sending && !bridge.injectPending()) {
+      s.state = SlotState::Empty;
+    }
+    if (s.state == SlotState::Holding && !s.stamped) {
+      s.stamped = true;
+      s.sinceMs = nowMs;
+    }
+  }
+
+  Slot* due = oldestDue(nowMs, edges);
+  if (!due || !bridge.injectBuffer(due->data, due->length)) return;
+  due->state = SlotState::Sending;
+  if (due->edges != edges) {
+    ++aligned_;
+  } else {
+    ++late_;
+  }
+}
+
+PpsSync::Slot* PpsSync::oldestDue(uint32_t nowMs, uint8_t edges) {
+  Slot* due = 0;
+  for (uint8_t i = 0; i < kSlots; ++i) {
+    Slot& s = slots_[i];
+    if (s.state != SlotState::Holding) continue;
+    // Without edges any more, everything held goes out now.
+    if (synced_ && s.edges == edges && nowMs - s.sinceMs < config_.timeoutMs) {
+      continue;
+    }
+    if (!due || static_cast<int16_t>(s.serial - due->serial) < 0) due = &s;
+  }
+  return due;
+}
+
+bool PpsSync::holding() const {
+  for (uint8_t i = 0; i < kSlots; ++i) {
+    if (slots_[i].state == SlotState::Holding) return true;
+  }
+  return false;
+}
+
+SleepRequest PpsSync::limit(const SleepRequest& request,
+                            uint32_t nowMs) const {
+  if (request.mode != SleepMode::PowerDown || !synced_ || !holding()) {
+    return request;
+  }
+  SleepRequest r = request;
+  const int32_t until =
+      static_cast<int32_t>(lastEdgeMs_ + 1000 - config_.guardMs - nowMs);
+  if (until <= 0) {
+    r.mode = SleepMode::Idle;
+    r.ms = 0;
+  } else if (until < r.ms) {
+    r.ms = static_cast<uint16_t>(until);
+  }
+  return r;
+}
+
+}  // namespace vx8
@@ -0,0 +1,115 @@
+// PPS-aligned output: GGA and RMC go to the radio on the module's pulse.
+//
+// Without it, a fix reaches the VX-8R whenever the module finishes
+// computing and printing it, which varies by tens to hundreds of
+// milliseconds from epoch to epoch. With a PPS pin wired up, the pulse
+// interrupt only counts edges (onPps()); this filter stage holds the GGA and
+// RMC of each whole second in a buffer of its own, and update() injects them
+// as soon as the main loop sees the next edge. The radio then gets every fix
+// a constant time after the second it describes, independent of the
+// module's output timing. Other sentences are not held.
+//
+// Held sentences are counted as filtered in BridgeStats and go out as an
+// injection (Bridge::injectBuffer()), so the receive buffer is not tied up
+// for a second. Two buffers are used: one can be filling while the other is
+// still being sent.
+//
+// It falls back to plain forwarding, so nothing is lost with the pin
+// unconnected or the fix gone:
+//   - while no edge has been seen for `lostMs`, nothing is held;
+//   - a held epoch with no edge `timeoutMs` after it started is sent anyway
+//     (counted as late);
+//   - sentences between whole seconds (modules faster than 1 Hz) and any
+//     that find both buffers in use pass straight through.
+//
+// Run it as the last filter stage, so that it holds what the other stages
+// produced. Like the power manager it runs on any millisecond clock, so
+// tests inject edges on a simulated one.
+
+#ifndef VX8_PPS_SYNC_H
+#define VX8_PPS_SYNC_H
+
+#include <stdint.h>
+
+#include "bridge.h"
+#include "nmea_parser.h"
+#include "power_manager.h"
+#include "sentence_edit.h"
+#include "vx8_config.h"
+
+namespace vx8 {
+
+struct PpsConfig {
+  uint8_t sentences;   // VX8_SENTENCE_* bits of the sentences to hold
+  uint16_t timeoutMs;  // send a held epoch anyway after this long
+  uint16_t lostMs;     // no edge for this long: forward without holding
+  uint16_t guardMs;    // wake this early before the next edge
+
+  static PpsConfig defaults();
+};
+
+class PpsSync {
+ public:
+  PpsSync();
+  explicit PpsSync(const PpsConfig& config);
+
+  // PPS interrupt, on the edge that marks the start of the second.
+  void onPps() { edges_ = static_cast<uint8_t>(edges_ + 1); }
+
+  // Filter stage: holds GGA/RMC while edges arrive.
+  bool apply(const NmeaParser& p, SentenceView& raw);
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw);
+
+  // Main loop, right after Bridge::poll(): injects a held epoch once the
+  // next edge has been seen (or it timed out).
+  void update(uint32_t nowMs, Bridge& bridge);
+
+  // Shortens a power-down so that the board is awake, and the edge
+  // interrupt can fire, when an epoch is waiting for it.
+  SleepRequest limit(const SleepRequest& request, uint32_t nowMs) const;
+
+  // Edges are arriving and GGA/RMC are being held.
+  bool synced() const { return synced_; }
+  bool holding() const;
+  // Epochs sent on an edge, and sent after timing out.
+  uint16_t aligned() const { return aligned_; }
+  uint16_t late() const { return late_; }
+
+  const PpsConfig& config() const { return config_; }
+
+ private:
+  static const uint8_t kSlots = 2;
+  static const uint8_t kSlotSize = 2 * (NmeaParser::kMaxSentence + 2);
+
+  enum class SlotState : uint8_t { Empty, Holding, Sending };
+
+  struct Slot {
+    uint8_t data[kSlotSize];
+    uint8_t length;
+    uint8_t held;      // VX8_SENTENCE_* bits
+    uint8_t edges;     // edge count when the first sentence was held
+    uint16_t serial;   // release order
+    uint32_t second;   // UTC second of day
+    uint32_t sinceMs;  // when update() first saw it
+    bool stamped;
+    SlotState state;
+  };
+
+  Slot* slotFor(uint32_t second, uint8_t edges);
+  Slot* oldestDue(uint32_t nowMs, uint8_t edges);
+
+  PpsConfig config_;
+  Slot slots_[kSlots];
+  volatile uint8_t edges_;
+  uint8_t seenEdges_;
+  uint16_t serial_;
+  uint32_t lastEdgeMs_;
+  bool haveEdge_;
+  bool synced_;
+  uint16_t aligned_;
+  uint16_t late_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_PPS_SYNC_H
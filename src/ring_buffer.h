@@ -0,0 +1,124 @@
+// Lock-free single-producer / single-consumer ring buffer.
+//
+// One side (typically an interrupt handler) only ever writes head_, the other
+// (typically the main loop) only ever writes tail_, so no interrupt masking is
+// needed. Indices are a single byte for rings of up to 256 slots, which makes
+// every index load and store atomic on 8-bit AVR. One slot is kept empty to
+// tell a full ring from an empty one.
+//
+// Besides push/pop, the consumer can read slots in place with at() and free
+// them in bulk with releaseTo(); the bridge uses this to forward sentences to
+// the radio straight out of the receive buffer.
+
+#ifndef VX8_RING_BUFFER_H
+#define VX8_RING_BUFFER_H
+
+#include <stdint.h>
+
+#include "vx8_platform.h"
+
+namespace vx8 {
+
+template <uint16_t Size>
+struct RingIndex {
+  typedef uint16_t type;
+};
+
+template <>
+struct RingIndex<2> { typedef uint8_t type; };
+template <>
+struct RingIndex<4> { typedef uint8_t type; };
+template <>
+struct RingIndex<8> { typedef uint8_t type; };
+template <>
+struct RingIndex<16> { typedef uint8_t type; };
+template <>
+struct RingIndex<32> { typedef uint8_t type; };
+template <>
+struct RingIndex<64> { typedef uint8_t type; };
+template <>
+struct RingIndex<128> { typedef uint8_t type; };
+template <>
+struct RingIndex<256> { typedef uint8_t type; };
+
+template <typename T, uint16_t Size>
+class SpscRing {
+ public:
+  static_assert(Size >= 2 && (Size & (Size - 1)) == 0,
+                "ring size must be a power of two");
+#if defined(__AVR__)
+  static_assert(Size <= 256, "AVR rings need single-byte indices");
+#endif
+
+  typedef typename RingIndex<Size>::type Index;
+  static const uint16_t kMask = Size - 1;
+
+  SpscRing() : head_(0), tail_(0) {}
+
+  // Usable capacity; one slot is always left free.
+  static uint16_t capacity() { return Size - 1; }
+
+  // Producer side.
+  bool push(const T& v) {
+    const Index h = head_;
+    const Index next = static_cast<Index>((h + 1) & kMask);
+    if (next == tail_) return false;
+    buf_[h] = v;
+    VX8_BARRIER();
+    head_ = next;
+    return true;
+  }
+
+  // Consumer side.
+  bool pop(T& out) {
+    const Index t = tail_;
+    if (t == head_) return false;
+    VX8_BARRIER();
+    out = buf_[t];
+    VX8_BARRIER();
+    tail_ = static_cast<Index>((t + 1) & kMask);
+    return true;
+  }
+
+  // Consumer side: the oldest element, left in place.
+  bool peek(T& out) const {
+    const Index t = tail_;
+    if (t == head_) return false;
+    VX8_BARRIER();
+    out = buf_[t];
+    return true;
+  }
+
+  // Consumer side: drops the oldest element after a successful peek().
+  void drop() { tail_ = static_cast<Index>((tail_ + 1) & kMask); }
+
+  // Either side may call these; the answer can only grow stale in the
+  // direction that is safe for the caller (producer sees less free space,
+  // consumer sees fewer elements).
+  uint16_t size() const { return (head_ - tail_) & kMask; }
+  bool empty() const { return head_ == tail_; }
+
+  // In-place access for zero-copy consumers. Indices wrap automatically.
+  Index headIndex() const { return head_; }
+  Index tailIndex() const { return tail_; }
+  T& at(uint16_t index) { return buf_[index & kMask]; }
+  const T& at(uint16_t index) const { return buf_[index & kMask]; }
+  static Index wrap(uint16_t index) {
+    return static_cast<Index>(index & kMask);
+  }
+
+  // Consumer side: frees every slot before `index`.
+  void releaseTo(Index index) {
+    VX8_BARRIER();
+    tail_ = index;
+  }
+
+ private:
+  T buf_[Size];
+  volatile Index head_;
+  volatile Index tail_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_RING_BUFFER_H
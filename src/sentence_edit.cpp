@@ -0,0 +1,38 @@
+#include "sentence_edit.h"
+
+namespace vx8 {
+
+bool SentenceView::writeUnsigned(uint8_t offset, uint8_t width,
+                                 uint32_t value) {
+  if (width == 0 || offset + width > starOffset_) return false;
+  uint8_t digits = 1;
+  for (uint32_t v = value; v >= 10; v /= 10) ++digits;
+  if (digits > width) return false;
+  for (uint8_t i = width; i > 0; --i) {
+    set(static_cast<uint8_t>(offset + i - 1),
+        static_cast<char>('0' + value % 10));
+    value /= 10;
+  }
+  return true;
+}
+
+bool SentenceView::truncateAt(uint8_t commaOffset) {
+  if (commaOffset >= starOffset_ || get(commaOffset) != ',') return false;
+  set(commaOffset, '*');
+  starOffset_ = commaOffset;
+  length_ = static_cast<uint8_t>(commaOffset + 3);
+  return true;
+}
+
+void SentenceView::updateChecksum() {
+  uint8_t sum = 0;
+  for (uint8_t i = 1; i < starOffset_; ++i) {
+    sum ^= static_cast<uint8_t>(get(i));
+  }
+  char hex[2];
+  formatChecksum(sum, hex);
+  set(static_cast<uint8_t>(starOffset_ + 1), hex[0]);
+  set(static_cast<uint8_t>(starOffset_ + 2), hex[1]);
+}
+
+}  // namespace vx8
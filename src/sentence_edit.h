@@ -0,0 +1,72 @@
+// In-place editing of a sentence that is already queued somewhere else.
+//
+// The bridge forwards sentences straight out of its receive ring, so any
+// rewriting has to happen there, byte by byte, without moving the sentence.
+// SentenceView addresses a sentence by its start index in a power-of-two
+// buffer and hides the wrap-around. Edits keep field widths unchanged (values
+// are zero-padded to the original width) except truncate(), which may only
+// shorten the sentence. Callers finish with updateChecksum().
+//
+// Offsets are measured from the '$', matching NmeaParser::fieldOffset().
+
+#ifndef VX8_SENTENCE_EDIT_H
+#define VX8_SENTENCE_EDIT_H
+
+#include <stdint.h>
+
+#include "nmea_parser.h"
+
+namespace vx8 {
+
+class SentenceView {
+ public:
+  // `mask` is the buffer size minus one; pass 0xFF for a plain array of up
+  // to 256 bytes starting at `start` 0.
+  SentenceView(uint8_t* base, uint16_t mask, uint16_t start, uint8_t length,
+               uint8_t starOffset)
+      : base_(base),
+        mask_(mask),
+        start_(start),
+        length_(length),
+        starOffset_(starOffset) {}
+
+  uint16_t start() const { return start_; }
+  uint8_t length() const { return length_; }
+  uint8_t starOffset() const { return starOffset_; }
+
+  char get(uint8_t offset) const {
+    return static_cast<char>(base_[(start_ + offset) & mask_]);
+  }
+  void set(uint8_t offset, char c) {
+    base_[(start_ + offset) & mask_] = static_cast<uint8_t>(c);
+  }
+
+  // Replaces the two talker characters after '$'.
+  void setTalker(char a, char b) {
+    set(1, a);
+    set(2, b);
+  }
+
+  // Overwrites the `width` characters at `offset` with `value`, zero-padded.
+  // Returns false, leaving the sentence untouched, if it does not fit.
+  bool writeUnsigned(uint8_t offset, uint8_t width, uint32_t value);
+
+  // Ends the sentence just before the comma at `commaOffset`, dropping that
+  // field and everything after it. The new checksum slot is left for
+  // updateChecksum() to fill.
+  bool truncateAt(uint8_t commaOffset);
+
+  // Recomputes the '*hh' checksum from the current contents.
+  void updateChecksum();
+
+ private:
+  uint8_t* base_;
+  uint16_t mask_;
+  uint16_t start_;
+  uint8_t length_;
+  uint8_t starOffset_;
+};
+
+}  // namespace vx8
+
+#endif  // VX8_SENTENCE_EDIT_H
@@ -0,0 +1,159 @@
+#include "ubx.h"
+
+namespace vx8 {
+namespace ubx {
+
+namespace {
+
+void putLe16(uint8_t* p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void putLe32(uint8_t* p, uint32_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  p[2] = static_cast<uint8_t>(v >> 16);
+  p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+}  // namespace
+
+uint8_t encode(uint8_t cls, uint8_t id, const uint8_t* payload, uint8_t len,
+               uint8_t* out) {
+  out[0] = kSync1;
+  out[1] = kSync2;
+  out[2] = cls;
+  out[3] = id;
+  putLe16(out + 4, len);
+  for (uint8_t i = 0; i < len; ++i) out[6 + i] = payload[i];
+  uint8_t a = 0, b = 0;
+  for (uint8_t i = 2; i < 6 + len; ++i) {
+    a = static_cast<uint8_t>(a + out[i]);
+    b = static_cast<uint8_t>(b + a);
+  }
+  out[6 + len] = a;
+  out[7 + len] = b;
+  return static_cast<uint8_t>(len + kFrameOverhead);
+}
+
+uint8_t cfgPrt(uint32_t baud, uint8_t* out) {
+  uint8_t p[20] = {0};
+  p[0] = 1;                 // portID: UART1
+  putLe32(p + 4, 0x08D0);   // mode: 8 data bits, no parity, 1 stop bit
+  putLe32(p + 8, baud);
+  putLe16(p + 12, 0x0003);  // inProtoMask: UBX | NMEA
+  putLe16(p + 14, 0x0003);  // outProtoMask: UBX | NMEA
+  return encode(kClassCfg, kIdCfgPrt, p, sizeof(p), out);
+}
+
+uint8_t cfgMsg(uint8_t msgClass, uint8_t msgId, uint8_t rate, uint8_t* out) {
+  const uint8_t p[3] = {msgClass, msgId, rate};
+  return encode(kClassCfg, kIdCfgMsg, p, sizeof(p), out);
+}
+
+uint8_t cfgRate(uint16_t measurementMs, uint8_t* out) {
+  uint8_t p[6];
+  putLe16(p, measurementMs);
+  putLe16(p + 2, 1);  // navRate: one solution per measurement
+  putLe16(p + 4, 1);  // timeRef: GPS time
+  return encode(kClassCfg, kIdCfgRate, p, sizeof(p), out);
+}
+
+uint8_t cfgRxm(bool powerSave, uint8_t* out) {
+  const uint8_t p[2] = {0x08, static_cast<uint8_t>(powerSave ? 1 : 0)};
+  return encode(kClassCfg, kIdCfgRxm, p, sizeof(p), out);
+}
+
+uint8_t cfgPm2(uint32_t updatePeriodMs, uint8_t* out) {
+  uint8_t p[44] = {0};
+  p[0] = 1;                     // version
+  putLe32(p + 4, 0x00021000);   // flags: cyclic tracking, update ephemeris
+  putLe32(p + 8, updatePeriodMs);
+  putLe32(p + 12, 10000);       // searchPeriod: retry acquisition every 10 s
+  return encode(kClassCfg, kIdCfgPm2, p, sizeof(p), out);
+}
+
+uint8_t poll(uint8_t cls, uint8_t id, uint8_t* out) {
+  return encode(cls, id, 0, 0, out);
+}
+
+void Parser::reset() {
+  state_ = State::Sync1;
+  cls_ = 0;
+  id_ = 0;
+  length_ = 0;
+  pos_ = 0;
+  ckA_ = 0;
+  ckB_ = 0;
+}
+
+Parser::Status Parser::feed(uint8_t c) {
+  switch (state_) {
+    case State::Sync1:
+      if (c == kSync1) state_ = State::Sync2;
+      return Status::Busy;
+    case State::Sync2:
+      if (c == kSync2) {
+        state_ = State::Class;
+      } else if (c != kSync1) {
+        state_ = State::Sync1;
+      }
+      ckA_ = ckB_ = 0;
+      return Status::Busy;
+    case State::CkA:
+      if (c != ckA_) {
+        state_ = State::Sync1;
+        return Status::Error;
+      }
+      state_ = State::CkB;
+      return Status::Busy;
+    case State::CkB:
+      state_ = State::Sync1;
+      return c == ckB_ ? Status::Frame : Status::Error;
+    default:
+      break;
+  }
+
+  // Every remaining byte is covered by the checksum.
+  ckA_ = static_cast<uint8_t>(ckA_ + c);
+  ckB_ = static_cast<uint8_t>(ckB_ + ckA_);
+  switch (state_) {
+    case State::Class:
+      cls_ = c;
+      state_ = State::Id;
+      break;
+    case State::Id:
+      id_ = c;
+      state_ = State::Length1;
+      break;
+    case State::Length1:
+      length_ = c;
+      state_ = State::Length2;
+      break;
+    case State::Length2:
+      length_ = static_cast<uint16_t>(length_ | (c << 8));
+      pos_ = 0;
+      state_ = length_ ? State::Payload : State::CkA;
+      break;
+    case State::Payload:
+      if (pos_ < kMaxPayload) payload_[pos_] = c;
+      if (++pos_ == length_) state_ = State::CkA;
+      break;
+    default:
+      break;
+  }
+  return Status::Busy;
+}
+
+bool Parser::isAck(bool& positive, uint8_t& ackClass, uint8_t& ackId) const {
+  if (cls_ != kClassAck || length_ != 2) return false;
+  if (id_ != kIdAckAck && id_ != kIdAckNak) return false;
+  positive = id_ == kIdAckAck;
+  ackClass = payload_[0];
+  ackId = payload_[1];
+  return true;
+}
+
+}  // namespace ubx
+}  // namespace vx8
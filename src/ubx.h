@@ -0,0 +1,115 @@
+// u-blox UBX binary protocol: the handful of frames needed to configure a
+// module at boot, and a streaming frame decoder for its acknowledgements.
+//
+// Frame layout: B5 62 class id length(LE16) payload ck_a ck_b, with an 8-bit
+// Fletcher checksum over class through payload. Encoders write a complete
+// frame into a caller buffer and return its length.
+
+#ifndef VX8_UBX_H
+#define VX8_UBX_H
+
+#include <stdint.h>
+
+namespace vx8 {
+namespace ubx {
+
+const uint8_t kSync1 = 0xB5;
+const uint8_t kSync2 = 0x62;
+const uint8_t kFrameOverhead = 8;
+
+const uint8_t kClassAck = 0x05;
+const uint8_t kIdAckNak = 0x00;
+const uint8_t kIdAckAck = 0x01;
+
+const uint8_t kClassCfg = 0x06;
+const uint8_t kIdCfgPrt = 0x00;
+const uint8_t kIdCfgMsg = 0x01;
+const uint8_t kIdCfgRate = 0x08;
+const uint8_t kIdCfgRxm = 0x11;
+const uint8_t kIdCfgPm2 = 0x3B;
+
+// Standard NMEA messages as addressed by CFG-MSG.
+const uint8_t kClassNmea = 0xF0;
+const uint8_t kNmeaGga = 0x00;
+const uint8_t kNmeaGll = 0x01;
+const uint8_t kNmeaGsa = 0x02;
+const uint8_t kNmeaGsv = 0x03;
+const uint8_t kNmeaRmc = 0x04;
+const uint8_t kNmeaVtg = 0x05;
+const uint8_t kNmeaGrs = 0x06;
+const uint8_t kNmeaGst = 0x07;
+const uint8_t kNmeaZda = 0x08;
+const uint8_t kNmeaGbs = 0x09;
+const uint8_t kNmeaDtm = 0x0A;
+const uint8_t kNmeaGns = 0x0D;
+
+// Largest frame the encoders below produce (CFG-PM2).
+const uint8_t kMaxEncodedFrame = kFrameOverhead + 44;
+
+uint8_t encode(uint8_t cls, uint8_t id, const uint8_t* payload, uint8_t len,
+               uint8_t* out);
+
+// CFG-PRT for UART1: 8N1 at `baud`, UBX+NMEA in, UBX+NMEA out (UBX output
+// is needed for acknowledgements; no UBX messages are enabled by default).
+uint8_t cfgPrt(uint32_t baud, uint8_t* out);
+
+// CFG-MSG, short form: output rate of one message on the current port, in
+// navigation solutions (0 disables it).
+uint8_t cfgMsg(uint8_t msgClass, uint8_t msgId, uint8_t rate, uint8_t* out);
+
+// CFG-RATE: measurement period in milliseconds, one solution per
+// measurement, aligned to GPS time.
+uint8_t cfgRate(uint16_t measurementMs, uint8_t* out);
+
+// CFG-RXM: continuous tracking (false) or the power save mode set up by
+// CFG-PM2 (true).
+uint8_t cfgRxm(bool powerSave, uint8_t* out);
+
+// CFG-PM2 (protocol 15+ layout): cyclic tracking, one fix every
+// `updatePeriodMs`, so NMEA output keeps its rate while the receiver powers
+// down its RF front end between fixes.
+uint8_t cfgPm2(uint32_t updatePeriodMs, uint8_t* out);
+
+// Empty-payload poll of a message; the module answers and acknowledges.
+uint8_t poll(uint8_t cls, uint8_t id, uint8_t* out);
+
+// Streaming decoder. Frames with payloads larger than kMaxPayload are
+// checksummed but their payload is not kept.
+class Parser {
+ public:
+  static const uint8_t kMaxPayload = 32;
+
+  enum class Status : uint8_t { Busy, Frame, Error };
+
+  Parser() { reset(); }
+  void reset();
+  Status feed(uint8_t c);
+
+  uint8_t msgClass() const { return cls_; }
+  uint8_t msgId() const { return id_; }
+  uint16_t length() const { return length_; }
+  // Only the first kMaxPayload bytes are available.
+  const uint8_t* payload() const { return payload_; }
+
+  // For ACK-ACK / ACK-NAK frames: the acknowledged class and id.
+  bool isAck(bool& positive, uint8_t& ackClass, uint8_t& ackId) const;
+
+ private:
+  enum class State : uint8_t {
+    Sync1, Sync2, Class, Id, Length1, Length2, Payload, CkA, CkB
+  };
+
+  State state_;
+  uint8_t cls_;
+  uint8_t id_;
+  uint16_t length_;
+  uint16_t pos_;
+  uint8_t ckA_;
+  uint8_t ckB_;
+  uint8_t payload_[kMaxPayload];
+};
+
+}  // namespace ubx
+}  // namespace vx8
+
+#endif  // VX8_UBX_H
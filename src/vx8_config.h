@@ -0,0 +1,210 @@
+// Build-time configuration. Override any of these with -D flags (or, in the
+// Arduino IDE, by defining them before including the library headers).
+
+#ifndef VX8_CONFIG_H
+#define VX8_CONFIG_H
+
+// Bytes of GPS input buffered between the RX interrupt and the main loop.
+// Must be a power of two. Sentences waiting to be sent to the radio stay in
+// this buffer until transmitted, so it has to hold one full 82-byte sentence
+// plus everything that arrives while the radio side sends one: roughly
+// 82 * (1 + GPS baud / radio baud). 256 covers equal baud rates; a module
+// running faster than the radio link needs a larger buffer (or, better, to
+// be told to send less; see the output profile). Boards with a UART per
+// side run the module at 115200 by default and get 2048.
+#ifndef VX8_RX_BUFFER_SIZE
+#if defined(ARDUINO) && !defined(__AVR__)
+#define VX8_RX_BUFFER_SIZE 2048
+#else
+#define VX8_RX_BUFFER_SIZE 256
+#endif
+#endif
+
+// Sentences that can be queued for the radio at once. Power of two.
+#ifndef VX8_TX_QUEUE_SIZE
+#define VX8_TX_QUEUE_SIZE 8
+#endif
+
+// Output profile defaults (output_profile.h). Sentence types to forward, as
+// a mask of VX8_SENTENCE_* bits.
+#define VX8_SENTENCE_GGA 0x02
+#define VX8_SENTENCE_RMC 0x04
+#define VX8_SENTENCE_GSA 0x08
+#define VX8_SENTENCE_GSV 0x10
+
+#ifndef VX8_PROFILE_SENTENCES
+#define VX8_PROFILE_SENTENCES \
+  (VX8_SENTENCE_GGA | VX8_SENTENCE_RMC | VX8_SENTENCE_GSA | VX8_SENTENCE_GSV)
+#endif
+
+// Rewrite the combined-GNSS "GN" talker to "GP", which the VX-8R expects.
+#ifndef VX8_PROFILE_GN_TO_GP
+#define VX8_PROFILE_GN_TO_GP 1
+#endif
+
+// Forward only the first epoch of each UTC second from 5-10 Hz modules.
+#ifndef VX8_PROFILE_ONE_HZ
+#define VX8_PROFILE_ONE_HZ 1
+#endif
+
+// Satellites reported in GSV; later GSV messages are dropped. 0 = no cap.
+#ifndef VX8_PROFILE_MAX_GSV_SATS
+#define VX8_PROFILE_MAX_GSV_SATS 12
+#endif
+
+// Drop the NMEA 4.1 trailing fields (RMC navigational status, GSA system ID,
+// GSV signal ID) that older receivers do not expect.
+#ifndef VX8_PROFILE_STRIP_NMEA41
+#define VX8_PROFILE_STRIP_NMEA41 1
+#endif
+
+// The VX-8R's GPS input.
+#ifndef VX8_RADIO_BAUD
+#define VX8_RADIO_BAUD 9600
+#endif
+
+// Boot-time GPS module configuration (module_config.h). On single-USART
+// boards the module and the radio share one baud rate, so the target is the
+// radio's 9600; boards with a UART per side (board.h) move it to 115200,
+// fast enough for 10 Hz input.
+#ifndef VX8_GPS_BAUD
+#if defined(ARDUINO) && !defined(__AVR__)
+#define VX8_GPS_BAUD 115200
+#else
+#define VX8_GPS_BAUD VX8_RADIO_BAUD
+#endif
+#endif
+
+#ifndef VX8_GPS_FIX_INTERVAL_MS
+#define VX8_GPS_FIX_INTERVAL_MS 1000
+#endif
+
+// Position hold and smoothing (motion_filter.h), chained after the output
+// profile. Set to 0 to forward positions as the module reports them.
+#ifndef VX8_MOTION_FILTER
+#define VX8_MOTION_FILTER 1
+#endif
+
+// Motion filter defaults (motion_filter.h). Below this speed (centi-knots)
+// a fix counts as stationary and the position is held.
+#ifndef VX8_MOTION_HOLD_SPEED
+#define VX8_MOTION_HOLD_SPEED 100
+#endif
+
+// Fixes with a worse HDOP (hundredths) never count as movement.
+#ifndef VX8_MOTION_MAX_HDOP
+#define VX8_MOTION_MAX_HDOP 300
+#endif
+
+// Consecutive stationary fixes before the position is held, and consecutive
+// moving fixes before it is released.
+#ifndef VX8_MOTION_HOLD_FIXES
+#define VX8_MOTION_HOLD_FIXES 3
+#endif
+
+#ifndef VX8_MOTION_MOVE_FIXES
+#define VX8_MOTION_MOVE_FIXES 2
+#endif
+
+// A held position is also released when the smoothed position wanders this
+// far (decimetres, scaled up by HDOP above 1.0) from it: slow real movement.
+#ifndef VX8_MOTION_RELEASE_DM
+#define VX8_MOTION_RELEASE_DM 250
+#endif
+
+// Below this speed (centi-knots) RMC reports the last course seen above it
+// rather than the jittering course of a near-stationary receiver.
+#ifndef VX8_MOTION_HEADING_SPEED
+#define VX8_MOTION_HEADING_SPEED 200
+#endif
+
+// Low-power mode (power_manager.h). Power the MCU down between the module's
+// output bursts once their timing is predictable (otherwise it only idles).
+#ifndef VX8_POWER_DOWN
+#define VX8_POWER_DOWN 1
+#endif
+
+// Wake this long (ms) before the next burst is due; doubled after every
+// burst that arrives early.
+#ifndef VX8_POWER_GUARD_MS
+#define VX8_POWER_GUARD_MS 60
+#endif
+
+// Switch a u-blox module to its cyclic power save mode after this many
+// consecutive good fixes (0 = never); back to continuous when the fix goes.
+#ifndef VX8_POWER_STABLE_FIXES
+#define VX8_POWER_STABLE_FIXES 10
+#endif
+
+// PPS-aligned output (pps_sync.h): hold GGA and RMC until the module's next
+// pulse, a rising edge on VX8_PPS_PIN. With nothing connected to the pin the
+// bridge forwards as usual.
+#ifndef VX8_PPS_SYNC
+#define VX8_PPS_SYNC 0
+#endif
+
+// An interrupt-capable pin: D3 (INT1) on the ATmega328P.
+#ifndef VX8_PPS_PIN
+#if defined(ARDUINO_ARCH_ESP32)
+#define VX8_PPS_PIN 18
+#else
+#define VX8_PPS_PIN 3
+#endif
+#endif
+
+// Track log (fix_logger.h): record fixes to SPI NOR flash, or to an SD card
+// with VX8_LOG_SD (AVR, SAMD and ESP32 only), selected by VX8_LOG_CS_PIN,
+// and stream them back out as NMEA or GPX on request. Without a chip
+// answering, logging stays off.
+#ifndef VX8_FIX_LOG
+#define VX8_FIX_LOG 0
+#endif
+
+#ifndef VX8_LOG_SD
+#define VX8_LOG_SD 0
+#endif
+
+#ifndef VX8_LOG_CS_PIN
+#if defined(ARDUINO_ARCH_SAMD)
+#define VX8_LOG_CS_PIN 4
+#elif defined(ARDUINO_ARCH_RP2040)
+#define VX8_LOG_CS_PIN 17
+#elif defined(ARDUINO_ARCH_ESP32)
+#define VX8_LOG_CS_PIN 15
+#else
+#define VX8_LOG_CS_PIN 10
+#endif
+#endif
+
+// Size of VX8LOG.BIN on the SD card, in 256-byte pages (4 MiB).
+#ifndef VX8_LOG_SD_PAGES
+#define VX8_LOG_SD_PAGES 16384
+#endif
+
+// At most one record per this many seconds.
+#ifndef VX8_LOG_INTERVAL_S
+#define VX8_LOG_INTERVAL_S 1
+#endif
+
+// Boards with a UART per side (board_hwserial.cpp): receive buffer of the
+// core's serial driver for the GPS port, which absorbs input while the
+// bridge's own buffer is full.
+#ifndef VX8_HW_SERIAL_BUFFER
+#define VX8_HW_SERIAL_BUFFER 1024
+#endif
+
+// ESP32 pins: GPS on UART2, radio on UART1 (its RX pin is unused).
+#ifndef VX8_ESP32_GPS_RX_PIN
+#define VX8_ESP32_GPS_RX_PIN 16
+#endif
+#ifndef VX8_ESP32_GPS_TX_PIN
+#define VX8_ESP32_GPS_TX_PIN 17
+#endif
+#ifndef VX8_ESP32_RADIO_RX_PIN
+#define VX8_ESP32_RADIO_RX_PIN 5
+#endif
+#ifndef VX8_ESP32_RADIO_TX_PIN
+#define VX8_ESP32_RADIO_TX_PIN 4
+#endif
+
+#endif  // VX8_CONFIG_H
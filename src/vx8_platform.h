@@ -0,0 +1,28 @@
+// The few compiler and platform details the core depends on.
+
+#ifndef VX8_PLATFORM_H
+#define VX8_PLATFORM_H
+
+// Orders memory accesses between an interrupt handler and the main loop.
+// AVR is single-core and in-order, so stopping the compiler from reordering
+// is enough; elsewhere a full fence also covers multi-core parts (RP2040,
+// ESP32) and the host build's threads.
+#if defined(__AVR__)
+#define VX8_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define VX8_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// Constant tables live in flash on AVR and must be read back explicitly.
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define VX8_PROGMEM PROGMEM
+#define VX8_READ_U8(addr) pgm_read_byte(addr)
+#define VX8_READ_U16(addr) pgm_read_word(addr)
+#else
+#define VX8_PROGMEM
+#define VX8_READ_U8(addr) (*(addr))
+#define VX8_READ_U16(addr) (*(addr))
+#endif
+
+#endif  // VX8_PLATFORM_H
@@ -0,0 +1,72 @@
+// Helpers for building NMEA input in tests and running it through a bridge.
+
+#ifndef VX8_TEST_NMEA_FIXTURES_H
+#define VX8_TEST_NMEA_FIXTURES_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "bridge.h"
+
+namespace vx8test {
+
+// "$<body>*hh\r\n" with the checksum computed.
+inline std::string nmea(const std::string& body) {
+  unsigned sum = 0;
+  for (char c : body) sum ^= static_cast<unsigned char>(c);
+  char tail[8];
+  std::snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return "$" + body + tail;
+}
+
+// One second of typical 1 Hz GPS-only output, stamped hh:mm:ss.
+inline std::string gpsEpoch(int h, int m, int s) {
+  char t[16];
+  std::snprintf(t, sizeof(t), "%02d%02d%02d.00", h, m, s);
+  const std::string time = t;
+  return nmea("GPGGA," + time + ",4807.03812,N,01131.00045,E,1,08,0.94,545.4,M,46.9,M,,") +
+         nmea("GPRMC," + time + ",A,4807.03812,N,01131.00045,E,0.12,84.40,230394,,,A") +
+         nmea("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1") +
+         nmea("GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45") +
+         nmea("GPGSV,2,2,08,15,12,101,31,17,55,041,44,19,33,261,40,24,66,152,47");
+}
+
+// One epoch of a multi-GNSS module (u-blox M8 style, NMEA 4.1) at
+// hh:mm:ss.cc: GN talker, one GSA per constellation, GPS and GLONASS GSV.
+inline std::string gnssEpoch(int h, int m, int s, int cs) {
+  char t[16];
+  std::snprintf(t, sizeof(t), "%02d%02d%02d.%02d", h, m, s, cs);
+  const std::string time = t;
+  return nmea("GNRMC," + time + ",A,4807.03812,N,01131.00045,E,0.012,,230394,,,A,V") +
+         nmea("GNVTG,,T,,M,0.012,N,0.022,K,A") +
+         nmea("GNGGA," + time + ",4807.03812,N,01131.00045,E,1,12,0.71,545.4,M,46.9,M,,") +
+         nmea("GNGSA,A,3,04,05,09,12,24,,,,,,,,1.32,0.71,1.11,1") +
+         nmea("GNGSA,A,3,65,66,,,,,,,,,,,1.32,0.71,1.11,2") +
+         nmea("GPGSV,4,1,14,01,40,083,46,02,17,308,41,04,07,344,39,05,22,228,45,1") +
+         nmea("GPGSV,4,2,14,09,12,101,31,12,55,041,44,15,33,261,40,17,66,152,47,1") +
+         nmea("GPGSV,4,3,14,19,12,101,31,22,55,041,44,24,33,261,40,25,66,152,47,1") +
+         nmea("GPGSV,4,4,14,28,08,201,,30,03,011,,1") +
+         nmea("GLGSV,1,1,02,65,40,083,36,66,17,308,31,1") +
+         nmea("GNGLL,4807.03812,N,01131.00045,E," + time + ",A,A");
+}
+
+// Runs input through a bridge filtered by `filter`, feeding it in 64-byte
+// chunks and draining the radio side after each, and returns the output.
+inline std::string forward(vx8::Bridge::SentenceFilter filter, void* ctx,
+                           const std::string& input) {
+  vx8::Bridge b;
+  b.setFilter(filter, ctx);
+  std::string out;
+  for (size_t i = 0; i < input.size(); i += 64) {
+    for (char c : input.substr(i, 64)) b.onRxByte(static_cast<uint8_t>(c));
+    b.poll();
+    uint8_t c;
+    while (b.nextTxByte(c)) out.push_back(static_cast<char>(c));
+  }
+  return out;
+}
+
+}  // namespace vx8test
+
+#endif  // VX8_TEST_NMEA_FIXTURES_H
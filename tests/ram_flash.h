@@ -0,0 +1,109 @@
+// NOR flash in RAM as a LogDevice (fix_log.h), for the track log tests.
+//
+// Programming only clears bits, a page may be programmed once per erase,
+// and every erase and program leaves the chip busy for `busyPolls` calls of
+// busy() (0: never busy). Anything that breaks those rules is counted in
+// `violations`. Programming `failPage` fails and writes nothing.
+
+#ifndef VX8_TEST_RAM_FLASH_H
+#define VX8_TEST_RAM_FLASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "fix_log.h"
+
+namespace vx8test {
+
+class RamFlash {
+ public:
+  RamFlash(uint32_t blocks, uint16_t pagesPerBlock, uint8_t busyPolls = 0)
+      : mem(blocks * pagesPerBlock * vx8::FixLog::kPageSize, 0xFF),
+        programmed(blocks * pagesPerBlock, false),
+        erases(blocks, 0),
+        pagesPerBlock_(pagesPerBlock),
+        busyPolls_(busyPolls) {}
+
+  vx8::LogDevice device() {
+    vx8::LogDevice d;
+    d.read = &RamFlash::read;
+    d.program = &RamFlash::program;
+    d.erase = &RamFlash::erase;
+    d.busy = &RamFlash::busy;
+    d.ctx = this;
+    d.pages = uint32_t(programmed.size());
+    d.pagesPerBlock = pagesPerBlock_;
+    return d;
+  }
+
+  // A program cut short by a reset: only the first `bytes` of the page.
+  void tear(uint32_t page, const uint8_t* data, uint16_t bytes) {
+    for (uint16_t i = 0; i < bytes; ++i) {
+      mem[page * vx8::FixLog::kPageSize + i] &= data[i];
+    }
+    programmed[page] = true;
+  }
+
+  std::vector<uint8_t> mem;
+  std::vector<bool> programmed;
+  std::vector<uint32_t> erases;
+  uint32_t programs = 0;
+  uint32_t violations = 0;
+  uint32_t failPage = UINT32_MAX;
+
+ private:
+  static RamFlash& self(void* ctx) { return *static_cast<RamFlash*>(ctx); }
+
+  void checkIdle() {
+    if (busyLeft_ != 0) ++violations;
+  }
+
+  static bool read(void* ctx, uint32_t page, uint8_t offset, uint8_t* data,
+                   uint16_t len) {
+    RamFlash& f = self(ctx);
+    f.checkIdle();
+    std::memcpy(data, &f.mem[page * vx8::FixLog::kPageSize + offset], len);
+    return true;
+  }
+
+  static bool program(void* ctx, uint32_t page, const uint8_t* data) {
+    RamFlash& f = self(ctx);
+    f.checkIdle();
+    if (f.programmed[page]) ++f.violations;
+    if (page == f.failPage) return false;
+    f.tear(page, data, vx8::FixLog::kPageSize);
+    ++f.programs;
+    f.busyLeft_ = f.busyPolls_;
+    return true;
+  }
+
+  static bool erase(void* ctx, uint32_t block) {
+    RamFlash& f = self(ctx);
+    f.checkIdle();
+    const uint32_t first = block * f.pagesPerBlock_;
+    std::memset(&f.mem[first * vx8::FixLog::kPageSize], 0xFF,
+                f.pagesPerBlock_ * vx8::FixLog::kPageSize);
+    for (uint32_t p = first; p < first + f.pagesPerBlock_; ++p) {
+      f.programmed[p] = false;
+    }
+    ++f.erases[block];
+    f.busyLeft_ = f.busyPolls_;
+    return true;
+  }
+
+  static bool busy(void* ctx) {
+    RamFlash& f = self(ctx);
+    if (f.busyLeft_ == 0) return false;
+    --f.busyLeft_;
+    return true;
+  }
+
+  uint16_t pagesPerBlock_;
+  uint8_t busyPolls_;
+  uint8_t busyLeft_ = 0;
+};
+
+}  // namespace vx8test
+
+#endif  // VX8_TEST_RAM_FLASH_H
@@ -0,0 +1,126 @@
+// A bridge stepped 1 ms at a time, for components whose behaviour depends on
+// when bytes arrive and leave: about one byte each way per step at 9600
+// baud. GPS bytes and edges (e.g. PPS) are scheduled in advance. Each step
+// delivers them, polls the bridge, calls the component's update hook and
+// sends one byte to the radio; every line that goes out is stamped with the
+// step its first byte was sent in.
+//
+// Tests add their filter stages to `chain` and set the hooks.
+
+#ifndef VX8_TEST_STEPPED_RIG_H
+#define VX8_TEST_STEPPED_RIG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bridge.h"
+#include "filter_chain.h"
+
+namespace vx8test {
+
+class SteppedRig {
+ public:
+  typedef void (*EdgeHook)(void* ctx);
+  typedef void (*UpdateHook)(void* ctx, uint32_t nowMs, vx8::Bridge& bridge);
+
+  struct Line {
+    uint32_t ms;
+    std::string text;
+  };
+
+  SteppedRig() { bridge.setFilter(&vx8::FilterChain::filter, &chain); }
+
+  // Called at each scheduled edge, before that step's bytes.
+  void onEdge(EdgeHook hook, void* ctx) {
+    edgeHook_ = hook;
+    edgeCtx_ = ctx;
+  }
+  // Called every step, after Bridge::poll().
+  void onUpdate(UpdateHook hook, void* ctx) {
+    updateHook_ = hook;
+    updateCtx_ = ctx;
+  }
+
+  void send(uint32_t atMs, const std::string& data) {
+    for (size_t i = 0; i < data.size(); ++i) {
+      rx_.push_back(Byte{atMs + uint32_t(i), static_cast<uint8_t>(data[i])});
+    }
+  }
+
+  // Edges at every whole second from `fromS` to before `toS`.
+  void pulses(int fromS, int toS) {
+    for (int s = fromS; s < toS; ++s) edges_.push_back(uint32_t(s) * 1000);
+  }
+
+  void run(uint32_t untilMs) {
+    for (; now_ < untilMs; ++now_) {
+      for (uint32_t e : edges_) {
+        if (e == now_ && edgeHook_) edgeHook_(edgeCtx_);
+      }
+      for (const Byte& b : rx_) {
+        if (b.ms == now_) bridge.onRxByte(b.b);
+      }
+      bridge.poll();
+      if (updateHook_) updateHook_(updateCtx_, now_, bridge);
+      uint8_t b;
+      if (bridge.nextTxByte(b)) {
+        if (line_.empty()) lineStart_ = now_;
+        line_.push_back(static_cast<char>(b));
+        if (b == '\n') {
+          lines.push_back(Line{lineStart_, line_});
+          line_.clear();
+        }
+      }
+    }
+  }
+
+  // Start of the first line out beginning with `prefix` after `fromMs`.
+  uint32_t sentAt(const std::string& prefix, uint32_t fromMs) const {
+    for (const Line& l : lines) {
+      if (l.ms >= fromMs && l.text.compare(0, prefix.size(), prefix) == 0) {
+        return l.ms;
+      }
+    }
+    return 0xFFFFFFFF;
+  }
+
+  // Milliseconds from the last GPS byte before `ms` to `ms`.
+  uint32_t quietBefore(uint32_t ms) const {
+    uint32_t last = 0;
+    for (const Byte& b : rx_) {
+      if (b.ms < ms && b.ms > last) last = b.ms;
+    }
+    return ms - last;
+  }
+
+  std::string radio() const {
+    std::string out;
+    for (const Line& l : lines) out += l.text;
+    return out;
+  }
+
+  vx8::FilterChain chain;
+  vx8::Bridge bridge;
+  std::vector<Line> lines;
+
+ private:
+  struct Byte {
+    uint32_t ms;
+    uint8_t b;
+  };
+
+  std::vector<Byte> rx_;
+  std::vector<uint32_t> edges_;
+  EdgeHook edgeHook_ = nullptr;
+  void* edgeCtx_ = nullptr;
+  UpdateHook updateHook_ = nullptr;
+  void* updateCtx_ = nullptr;
+  uint32_t now_ = 0;
+  uint32_t lineStart_ = 0;
+  std::string line_;
+};
+
+}  // namespace vx8test
+
+#endif  // VX8_TEST_STEPPED_RIG_H
@@ -0,0 +1,181 @@
+#include "board_linux.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+#include "board.h"
+#include "firmware.h"
+#include "log_media.h"
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+bool writeAll(int fd, const std::string& s) {
+  return write(fd, s.data(), s.size()) == ssize_t(s.size());
+}
+
+std::string readAll(int fd) {
+  std::string out;
+  char buf[512];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) out.append(buf, size_t(n));
+  return out;
+}
+
+uint64_t g_testNs = 0;
+uint64_t testClock() { return g_testNs; }
+
+std::string capture() {
+  return vx8test::gpsEpoch(8, 30, 0) + vx8test::gpsEpoch(8, 30, 1);
+}
+
+}  // namespace
+
+TEST(runs_the_firmware_between_pipes) {
+  int in[2], out[2];
+  CHECK_EQ(pipe(in), 0);
+  CHECK_EQ(pipe(out), 0);
+  const std::string query = vx8test::nmea("PVX8Q");
+  CHECK(writeAll(in[1], capture() + query));
+  close(in[1]);
+
+  board::useFds(in[0], out[1]);
+  static Firmware firmware;
+  firmware.setup(false);
+  CHECK(!board::sharedLine());
+  for (int i = 0; i < 1000 && !(board::inputClosed() && firmware.drained());
+       ++i) {
+    firmware.loop();
+  }
+  CHECK(board::inputClosed());
+  close(out[1]);
+  const std::string radio = readAll(out[0]);
+  close(in[0]);
+  close(out[0]);
+
+  // The report goes out between sentences, wherever the query was parsed.
+  std::string forwarded, reports;
+  for (size_t at = 0; at < radio.size();) {
+    const size_t end = radio.find('\n', at) + 1;
+    (radio.compare(at, 7, "$PVX8S,") == 0 ? reports : forwarded) +=
+        radio.substr(at, end - at);
+    at = end;
+  }
+  CHECK(forwarded == capture());
+  const std::string bytesIn =
+      "$PVX8S,1," + std::to_string(capture().size() + query.size()) + ",";
+  CHECK_EQ(reports.compare(0, bytesIn.size(), bytesIn), 0);
+  CHECK(reports.find("\n$PVX8S,2,0,0,1,0,") != std::string::npos);
+}
+
+TEST(reads_the_gps_side_from_a_pty) {
+  char path[64];
+  const int master = board::openPty(path, sizeof(path));
+  CHECK(master >= 0);
+  if (master < 0) return;
+  const int slave = open(path, O_RDWR | O_NOCTTY);
+  CHECK(slave >= 0);
+  int out[2];
+  CHECK_EQ(pipe(out), 0);
+  fcntl(out[0], F_SETFL, O_NONBLOCK);
+
+  board::useFds(master, out[1]);
+  static Firmware firmware;
+  firmware.setup(false);
+  CHECK(writeAll(slave, capture()));
+  std::string radio;
+  const uint32_t start = board::clockMs();
+  while (radio.size() < capture().size() && board::clockMs() - start < 2000) {
+    firmware.loop();
+    radio += readAll(out[0]);
+  }
+  CHECK(radio == capture());
+  CHECK(!board::inputClosed());
+  close(slave);
+  close(master);
+  close(out[0]);
+  close(out[1]);
+}
+
+TEST(holds_fixes_for_the_pps_edge) {
+  int in[2], out[2];
+  CHECK_EQ(pipe(in), 0);
+  CHECK_EQ(pipe(out), 0);
+  fcntl(out[0], F_SETFL, O_NONBLOCK);
+  board::useFds(in[0], out[1]);
+  // The clock stands still, so however slowly this runs the held epoch
+  // cannot time out before the edge.
+  board::useClock(&testClock);
+  static Firmware firmware;
+  firmware.setup(false);
+
+  board::pulsePps();
+  firmware.loop();
+  CHECK(firmware.pps().synced());
+  const std::string epoch = vx8test::gpsEpoch(8, 30, 0);
+  const size_t gsa = epoch.find("$GPGSA");
+  CHECK(writeAll(in[1], epoch));
+  std::string radio;
+  for (int i = 0; i < 1000 && radio.size() < epoch.size() - gsa; ++i) {
+    firmware.loop();
+    radio += readAll(out[0]);
+  }
+  CHECK(radio == epoch.substr(gsa));
+  CHECK(firmware.pps().holding());
+  CHECK(!firmware.drained());
+
+  g_testNs += 300000000;  // the edge, 300 ms later
+  board::pulsePps();
+  for (int i = 0; i < 1000 && !firmware.drained(); ++i) firmware.loop();
+  board::useClock(nullptr);
+  radio += readAll(out[0]);
+  CHECK(radio == epoch.substr(gsa) + epoch.substr(0, gsa));
+  CHECK_EQ(firmware.pps().aligned(), 1);
+  close(in[1]);
+  close(in[0]);
+  close(out[0]);
+  close(out[1]);
+}
+
+TEST(keeps_the_track_log_in_a_file) {
+  int in[2], out[2];
+  CHECK_EQ(pipe(in), 0);
+  CHECK_EQ(pipe(out), 0);
+  CHECK(writeAll(in[1], capture()));
+  close(in[1]);
+  FILE* file = tmpfile();
+  CHECK(file != nullptr);
+  board::useFds(in[0], out[1]);
+  board::useLogFile(fileno(file), 64);
+  static Firmware firmware;
+  firmware.setup(false);
+  CHECK(firmware.logger().log().enabled());
+  for (int i = 0; i < 1000 && !(board::inputClosed() && firmware.drained());
+       ++i) {
+    firmware.loop();
+  }
+  CHECK_EQ(firmware.logger().records(), 2u);
+  firmware.logger().flush();
+  while (!firmware.logger().log().flushed()) firmware.loop();
+
+  // As vx8_logdump reads it.
+  FixLog log;
+  CHECK(log.begin(fileLog(fileno(file), 64, 16)));
+  LogCursor c;
+  log.rewind(c);
+  FixRecord r;
+  CHECK(log.next(c, r) && r.satellites == 8);
+  CHECK(log.next(c, r) && r.time % 60 == 1);
+  CHECK(!log.next(c, r));
+  board::useLogFile(-1, 0);
+  fclose(file);
+  close(in[0]);
+  close(out[0]);
+  close(out[1]);
+}
@@ -0,0 +1,78 @@
+#include "filter_chain.h"
+
+#include <string>
+
+#include "motion_filter.h"
+#include "nmea_fixtures.h"
+#include "output_profile.h"
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+std::string run(FilterChain& chain, const std::string& input) {
+  return vx8test::forward(&FilterChain::filter, &chain, input);
+}
+
+bool noGsv(void*, const NmeaParser& p, SentenceView&) {
+  return p.type() != SentenceType::GSV;
+}
+
+// Counts calls; sees only what earlier stages let through.
+bool count(void* ctx, const NmeaParser&, SentenceView&) {
+  ++*static_cast<int*>(ctx);
+  return true;
+}
+
+}  // namespace
+
+TEST(empty_chain_accepts_everything) {
+  FilterChain chain;
+  const std::string in = vx8test::gpsEpoch(12, 0, 0);
+  CHECK_EQ(run(chain, in), in);
+}
+
+TEST(stages_run_in_order_and_any_can_reject) {
+  FilterChain chain;
+  int seen = 0;
+  CHECK(chain.add(&noGsv, 0));
+  CHECK(chain.add(&count, &seen));
+  const std::string out = run(chain, vx8test::gpsEpoch(12, 0, 0));
+  CHECK_EQ(seen, 3);
+  CHECK(out.find("GSV") == std::string::npos);
+}
+
+TEST(chain_is_bounded) {
+  FilterChain chain;
+  int seen = 0;
+  for (uint8_t i = 0; i < FilterChain::kMaxStages; ++i) {
+    CHECK(chain.add(&count, &seen));
+  }
+  CHECK(!chain.add(&count, &seen));
+}
+
+TEST(later_stages_see_earlier_edits) {
+  OutputProfile profile;
+  MotionFilter motion;
+  FilterChain chain;
+  chain.add(&OutputProfile::filter, &profile);
+  chain.add(&MotionFilter::filter, &motion);
+  std::string in;
+  for (int s = 0; s < 5; ++s) {
+    for (int cs = 0; cs < 100; cs += 20) in += vx8test::gnssEpoch(10, 0, s, cs);
+  }
+  const std::string out = run(chain, in);
+  NmeaParser p;
+  int sentences = 0, errors = 0;
+  for (char c : out) {
+    const NmeaParser::Status st = p.feed(static_cast<uint8_t>(c));
+    if (st == NmeaParser::Status::Error) ++errors;
+    if (st != NmeaParser::Status::Sentence) continue;
+    ++sentences;
+    CHECK(p.talker() == Talker::GP);
+  }
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(sentences, 5 * 6);
+  CHECK(motion.holding());
+}
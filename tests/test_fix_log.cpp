@@ -0,0 +1,289 @@
+#include "fix_log.h"
+
+#include <cstring>
+#include <vector>
+
+#include "ram_flash.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::RamFlash;
+
+namespace {
+
+FixRecord record(uint32_t time) {
+  FixRecord r;
+  r.time = time;
+  r.latitude = 288703812 + int32_t(time);
+  r.longitude = -69100045 - int32_t(time);
+  r.speed = 12;
+  r.course = 8440;
+  r.hdop = 94;
+  r.satellites = 8;
+  return r;
+}
+
+// Appends records `from`..`to` - 1, writing as they fill pages: enough
+// updates for an erase and a program on a device that is never busy.
+void fill(FixLog& log, uint32_t from, uint32_t to) {
+  for (uint32_t t = from; t < to; ++t) {
+    CHECK(log.append(record(t)));
+    log.update();
+    log.update();
+  }
+}
+
+void drain(FixLog& log) {
+  log.flush();
+  while (!log.flushed() || !log.ready()) log.update();
+}
+
+std::vector<uint32_t> readAll(const FixLog& log) {
+  std::vector<uint32_t> times;
+  LogCursor c;
+  log.rewind(c);
+  FixRecord r;
+  while (log.next(c, r)) times.push_back(r.time);
+  return times;
+}
+
+bool consecutive(const std::vector<uint32_t>& times) {
+  for (size_t i = 1; i < times.size(); ++i) {
+    if (times[i] != times[i - 1] + 1) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(records_round_trip_and_fail_when_damaged) {
+  FixRecord in = record(7);
+  in.course = kNoValue16;
+  uint8_t raw[FixRecord::kSize];
+  in.encode(raw);
+  FixRecord out;
+  CHECK(out.decode(raw));
+  CHECK_EQ(out.time, 7u);
+  CHECK_EQ(out.latitude, in.latitude);
+  CHECK_EQ(out.longitude, in.longitude);
+  CHECK_EQ(out.speed, 12);
+  CHECK_EQ(out.course, kNoValue16);
+  CHECK_EQ(out.hdop, 94);
+  CHECK_EQ(out.satellites, 8);
+  raw[5] ^= 0x10;
+  CHECK(!out.decode(raw));
+  std::memset(raw, 0xFF, sizeof(raw));
+  CHECK(!out.decode(raw));  // erased
+}
+
+TEST(log_time_counts_from_2000_through_leap_days) {
+  UtcDate d = {1, 1, 0};
+  UtcTime t = {0, 0, 0, 0};
+  CHECK_EQ(logTime(d, t), 0u);
+  const UtcDate feb28 = {28, 2, 24};
+  const UtcDate feb29 = {29, 2, 24};
+  const UtcDate mar1 = {1, 3, 24};
+  CHECK_EQ(logTime(feb29, t) - logTime(feb28, t), 86400u);
+  CHECK_EQ(logTime(mar1, t) - logTime(feb29, t), 86400u);
+  const UtcDate y2001 = {1, 1, 1};
+  CHECK_EQ(logTime(y2001, t), 366u * 86400u);
+
+  const UtcTime noon = {12, 34, 56, 0};
+  const UtcDate dates[] = {feb29, mar1, {31, 12, 99}, {23, 3, 94}};
+  for (const UtcDate& in : dates) {
+    splitLogTime(logTime(in, noon), d, t);
+    CHECK_EQ(d.day, in.day);
+    CHECK_EQ(d.month, in.month);
+    CHECK_EQ(d.year, in.year);
+    CHECK_EQ(t.hour, 12);
+    CHECK_EQ(t.minute, 34);
+    CHECK_EQ(t.second, 56);
+  }
+}
+
+TEST(programs_whole_pages_once) {
+  RamFlash flash(4, 16);
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  fill(log, 0, FixLog::kRecordsPerPage - 1);
+  CHECK_EQ(flash.programs, 0u);  // nothing until the page is full
+  fill(log, FixLog::kRecordsPerPage - 1, FixLog::kRecordsPerPage + 3);
+  CHECK_EQ(flash.programs, 1u);
+  CHECK_EQ(readAll(log).size(), size_t(FixLog::kRecordsPerPage));
+  drain(log);  // the short page
+  CHECK_EQ(flash.programs, 2u);
+  const std::vector<uint32_t> times = readAll(log);
+  CHECK_EQ(times.size(), size_t(FixLog::kRecordsPerPage + 3));
+  CHECK(consecutive(times));
+  CHECK_EQ(flash.violations, 0u);
+  CHECK_EQ(log.dropped(), 0);
+}
+
+TEST(wraps_and_wears_blocks_evenly) {
+  RamFlash flash(4, 4);
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  const uint32_t total = 16 * FixLog::kRecordsPerPage * 10 + 5;
+  fill(log, 0, total);
+  drain(log);
+  CHECK_EQ(flash.violations, 0u);
+  uint32_t least = flash.erases[0], most = flash.erases[0];
+  for (uint32_t e : flash.erases) {
+    least = e < least ? e : least;
+    most = e > most ? e : most;
+  }
+  CHECK(most - least <= 1);
+  CHECK(least >= 9);
+  // Three blocks and the page being filled in the fourth survive.
+  const std::vector<uint32_t> times = readAll(log);
+  CHECK(consecutive(times));
+  CHECK(!times.empty() && times.back() == total - 1);
+  CHECK(times.size() >= 12u * FixLog::kRecordsPerPage);
+}
+
+TEST(continues_after_a_reset) {
+  RamFlash flash(8, 4);
+  {
+    FixLog log;
+    CHECK(log.begin(flash.device()));
+    fill(log, 0, 30);
+    drain(log);
+  }
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  CHECK_EQ(log.sequence(), 3u);
+  fill(log, 30, 200);
+  drain(log);
+  CHECK_EQ(flash.violations, 0u);
+  const std::vector<uint32_t> times = readAll(log);
+  CHECK_EQ(times.size(), 200u);
+  CHECK(consecutive(times));
+  CHECK_EQ(times.front(), 0u);
+
+  // And again after the log has wrapped.
+  fill(log, 200, 500);
+  drain(log);
+  FixLog again;
+  CHECK(again.begin(flash.device()));
+  CHECK_EQ(again.sequence(), log.sequence());
+  CHECK(readAll(again) == readAll(log));
+}
+
+TEST(gives_up_the_block_of_a_torn_page) {
+  RamFlash flash(4, 4);
+  {
+    FixLog log;
+    CHECK(log.begin(flash.device()));
+    fill(log, 0, 2 * FixLog::kRecordsPerPage);
+    drain(log);
+  }
+  // A reset during the third page's program: only part of its header.
+  uint8_t partial[FixLog::kPageSize];
+  std::memset(partial, 0, sizeof(partial));
+  partial[0] = 'V';
+  partial[1] = 'L';
+  flash.tear(2, partial, 4);
+
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  fill(log, 100, 100 + 3 * FixLog::kRecordsPerPage);
+  drain(log);
+  CHECK_EQ(flash.violations, 0u);
+  CHECK_EQ(flash.erases[0], 1u);  // the old pages are kept
+  const std::vector<uint32_t> times = readAll(log);
+  CHECK_EQ(times.size(), 5u * FixLog::kRecordsPerPage);
+  CHECK_EQ(times.front(), 0u);
+  CHECK_EQ(times[2 * FixLog::kRecordsPerPage], 100u);
+  CHECK(consecutive(std::vector<uint32_t>(
+      times.begin() + 2 * FixLog::kRecordsPerPage, times.end())));
+}
+
+TEST(skips_records_cut_short_by_a_reset) {
+  RamFlash flash(4, 4);
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  fill(log, 0, FixLog::kRecordsPerPage);
+  // Erase the last three records of the page, as a program cut short
+  // would have left them.
+  const size_t end = FixLog::kHeaderSize +
+                     FixLog::kRecordsPerPage * FixRecord::kSize;
+  for (size_t i = end - 3 * FixRecord::kSize; i < end; ++i) flash.mem[i] = 0xFF;
+  FixLog after;
+  CHECK(after.begin(flash.device()));
+  const std::vector<uint32_t> times = readAll(after);
+  CHECK_EQ(times.size(), size_t(FixLog::kRecordsPerPage - 3));
+  CHECK(consecutive(times));
+}
+
+TEST(reads_past_a_page_that_failed_to_program) {
+  RamFlash flash(4, 4);
+  flash.failPage = 1;
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  fill(log, 0, 4 * FixLog::kRecordsPerPage);
+  drain(log);
+  CHECK_EQ(log.deviceErrors(), 1);
+  const std::vector<uint32_t> times = readAll(log);
+  CHECK_EQ(times.size(), 3u * FixLog::kRecordsPerPage);
+  CHECK_EQ(times[FixLog::kRecordsPerPage], 2u * FixLog::kRecordsPerPage);
+  CHECK_EQ(times.back(), 4u * FixLog::kRecordsPerPage - 1);
+
+  // And after a reset, which finds the gap in the sequence again.
+  FixLog again;
+  CHECK(again.begin(flash.device()));
+  CHECK(readAll(again) == times);
+}
+
+TEST(reader_overtaken_by_the_writer_skips_ahead) {
+  RamFlash flash(4, 2);
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  fill(log, 0, 8 * FixLog::kRecordsPerPage);
+  LogCursor c;
+  log.rewind(c);
+  FixRecord r;
+  CHECK(log.next(c, r));
+  CHECK_EQ(r.time, 0u);
+  fill(log, 8 * FixLog::kRecordsPerPage, 12 * FixLog::kRecordsPerPage);
+  std::vector<uint32_t> times;
+  while (log.next(c, r)) times.push_back(r.time);
+  CHECK(!times.empty());
+  CHECK(times.front() >= 2u * 2 * FixLog::kRecordsPerPage);
+  CHECK(consecutive(times));
+  CHECK_EQ(times.back(), 12u * FixLog::kRecordsPerPage - 1);
+}
+
+TEST(never_waits_for_a_busy_device) {
+  RamFlash flash(4, 4, 50);  // a sector erase takes 50 polls
+  FixLog log;
+  CHECK(log.begin(flash.device()));
+  for (uint32_t t = 0; t < FixLog::kRecordsPerPage; ++t) log.append(record(t));
+  log.update();  // erases the first block
+  CHECK_EQ(flash.erases[0], 1u);
+  CHECK_EQ(flash.programs, 0u);
+  CHECK(!log.ready());
+  // Records keep coming while it is busy; one page's worth is held.
+  CHECK(!log.append(record(99)));
+  CHECK_EQ(log.dropped(), 1);
+  for (int i = 0; i < 48; ++i) log.update();
+  CHECK_EQ(flash.programs, 0u);
+  log.update();
+  log.update();
+  CHECK_EQ(flash.programs, 1u);
+  CHECK_EQ(flash.violations, 0u);
+}
+
+TEST(stays_off_without_a_device) {
+  RamFlash flash(1, 16);
+  LogDevice none = flash.device();
+  none.pages = 0;
+  FixLog log;
+  CHECK(!log.begin(none));
+  CHECK(!log.enabled());
+  CHECK(!log.append(record(1)));
+  log.update();
+  CHECK(readAll(log).empty());
+  LogDevice uneven = flash.device();
+  uneven.pages = 20;  // not whole blocks
+  CHECK(!log.begin(uneven));
+}
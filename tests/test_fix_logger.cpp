@@ -0,0 +1,208 @@
+#include "fix_logger.h"
+
+#include <string>
+#include <vector>
+
+#include "nmea_fixtures.h"
+#include "ram_flash.h"
+#include "stepped_rig.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::nmea;
+using Line = vx8test::SteppedRig::Line;
+
+namespace {
+
+// The stepped rig with the logger as its only stage, logging to RAM.
+class Rig : public vx8test::SteppedRig {
+ public:
+  explicit Rig(uint8_t intervalS = 1) : flash(4, 16), logger(intervalS) {
+    logger.begin(flash.device());
+    chain.add(&FixLogger::filter, &logger);
+    onUpdate(&update, &logger);
+  }
+
+  vx8test::RamFlash flash;
+  FixLogger logger;
+
+ private:
+  static void update(void* ctx, uint32_t nowMs, Bridge& bridge) {
+    static_cast<FixLogger*>(ctx)->update(nowMs, bridge);
+  }
+};
+
+// Runs the logger and notes when it erased or programmed the device.
+struct WriteWatch {
+  Rig* rig;
+  std::vector<uint32_t> at;
+
+  static void update(void* ctx, uint32_t nowMs, Bridge& bridge) {
+    WriteWatch& w = *static_cast<WriteWatch*>(ctx);
+    const uint32_t before = w.rig->flash.programs + w.rig->flash.erases[0];
+    w.rig->logger.update(nowMs, bridge);
+    if (w.rig->flash.programs + w.rig->flash.erases[0] != before) {
+      w.at.push_back(nowMs);
+    }
+  }
+};
+
+std::vector<FixRecord> logged(FixLogger& logger) {
+  std::vector<FixRecord> out;
+  LogCursor c;
+  logger.log().rewind(c);
+  FixRecord r;
+  while (logger.log().next(c, r)) out.push_back(r);
+  return out;
+}
+
+}  // namespace
+
+TEST(logs_one_record_per_epoch) {
+  Rig rig;
+  for (int s = 0; s < 15; ++s) {
+    rig.send(uint32_t(s) * 1000, vx8test::gpsEpoch(8, 30, s));
+  }
+  rig.run(15000);
+  CHECK_EQ(rig.logger.records(), 15u);
+  rig.logger.flush();
+  rig.run(15010);
+  const std::vector<FixRecord> recs = logged(rig.logger);
+  CHECK_EQ(recs.size(), 15u);
+  UtcDate d;
+  UtcTime t;
+  splitLogTime(recs[3].time, d, t);
+  CHECK(t.hour == 8 && t.minute == 30 && t.second == 3);
+  CHECK(d.day == 23 && d.month == 3 && d.year == 94);
+  CHECK_EQ(recs[3].latitude, 288703812);
+  CHECK_EQ(recs[3].longitude, 69100045);
+  CHECK_EQ(recs[3].speed, 12);
+  CHECK_EQ(recs[3].course, 8440);
+  CHECK_EQ(recs[3].hdop, 94);
+  CHECK_EQ(recs[3].satellites, 8);
+  CHECK_EQ(recs[14].time - recs[0].time, 14u);
+}
+
+TEST(logs_at_the_configured_interval_and_only_with_a_fix) {
+  Rig rig(5);
+  for (int s = 0; s < 12; ++s) {
+    rig.send(uint32_t(s) * 1000, vx8test::gpsEpoch(8, 30, s));
+  }
+  rig.send(12000, nmea("GPGGA,083012.00,,,,,0,00,99.99,,,,,,") +
+                      nmea("GPRMC,083012.00,V,,,,,,,230394,,,N"));
+  rig.run(13000);
+  CHECK_EQ(rig.logger.records(), 3u);  // :00, :05, :10
+
+  // RMC alone is enough; satellites and HDOP stay unknown.
+  Rig rmcOnly;
+  rmcOnly.send(0, nmea("GPRMC,083000.00,A,4807.03812,N,01131.00045,E,0.12,"
+                       "84.40,230394,,,A"));
+  rmcOnly.run(1000);
+  CHECK_EQ(rmcOnly.logger.records(), 0u);  // waiting for the GGA
+  rmcOnly.logger.flush();
+  rmcOnly.run(1010);
+  const std::vector<FixRecord> recs = logged(rmcOnly.logger);
+  CHECK_EQ(recs.size(), 1u);
+  CHECK(!recs.empty() && recs[0].hdop == kNoValue16 &&
+        recs[0].satellites == 0);
+}
+
+TEST(skips_fixes_without_a_valid_date) {
+  Rig rig;
+  const std::string gga =
+      nmea("GPGGA,083000.00,4807.03812,N,01131.00045,E,1,08,0.94,545.4,M,"
+           "46.9,M,,");
+  rig.send(0, gga + nmea("GPRMC,083000.00,A,4807.03812,N,01131.00045,E,"
+                         "0.12,84.40,,,,A"));
+  rig.send(1000, gga + nmea("GPRMC,083000.00,A,4807.03812,N,01131.00045,E,"
+                            "0.12,84.40,231394,,,A"));
+  rig.run(2000);
+  rig.logger.flush();
+  rig.run(2010);
+  CHECK_EQ(rig.logger.records(), 0u);
+  CHECK(logged(rig.logger).empty());
+}
+
+TEST(writes_the_device_only_between_bursts) {
+  Rig rig;
+  WriteWatch watch{&rig, {}};
+  rig.onUpdate(&WriteWatch::update, &watch);
+  for (int s = 0; s < 30; ++s) {
+    rig.send(uint32_t(s) * 1000, vx8test::gpsEpoch(8, 30, s));
+  }
+  rig.run(30000);
+  CHECK_EQ(rig.flash.programs, 2u);
+  CHECK_EQ(watch.at.size(), 3u);  // the first block's erase, two pages
+  for (uint32_t ms : watch.at) {
+    CHECK(rig.quietBefore(ms) >= FixLogger::kQuietMs);
+  }
+}
+
+TEST(export_goes_out_between_bursts) {
+  Rig rig;
+  std::vector<std::string> expected;
+  for (int s = 0; s < 20; ++s) {
+    const std::string epoch = vx8test::gpsEpoch(8, 30, s);
+    rig.send(uint32_t(s) * 1000, epoch);
+    for (size_t i = 0; i < epoch.size();) {
+      const size_t end = epoch.find('\n', i) + 1;
+      expected.push_back(epoch.substr(i, end - i));
+      i = end;
+    }
+  }
+  rig.send(10500, nmea("PVX8L"));
+  rig.run(21000);
+  CHECK(!rig.logger.exporting());
+
+  // Forwarded sentences in order, exported lines wherever there was room.
+  size_t k = 0;
+  std::vector<Line> exported;
+  for (const Line& l : rig.lines) {
+    if (k < expected.size() && l.text == expected[k]) {
+      ++k;
+    } else {
+      exported.push_back(l);
+    }
+  }
+  CHECK_EQ(k, expected.size());  // nothing lost, nor the query forwarded
+  CHECK_EQ(exported.size(), 2u * 11);  // records up to 08:30:10
+  for (const Line& l : exported) {
+    CHECK(l.ms > 10500);
+    CHECK(rig.quietBefore(l.ms) >= FixLogger::kQuietMs);
+    CHECK(l.text.compare(0, 3, "$GP") == 0);
+  }
+  CHECK(!exported.empty() &&
+        exported[0].text.compare(0, 17, "$GPRMC,083000.00,") == 0);
+  CHECK(exported.size() == 22 &&
+        exported[21].text == nmea("GPGGA,083010.00,4807.03812,N,01131.00045,"
+                                  "E,1,08,0.94,,M,,M,,"));
+  // It takes more than one gap, but not many.
+  CHECK(exported.back().ms > 11000 && exported.back().ms < 14000);
+}
+
+TEST(exports_gpx_on_request) {
+  Rig rig;
+  for (int s = 0; s < 3; ++s) {
+    rig.send(uint32_t(s) * 1000, vx8test::gpsEpoch(8, 30, s));
+  }
+  rig.send(2600, nmea("PVX8L,GPX"));
+  rig.run(4000);
+  std::vector<std::string> gpx;
+  for (const Line& l : rig.lines) {
+    if (l.text[0] == '<') gpx.push_back(l.text);
+  }
+  CHECK_EQ(gpx.size(), 3u + 3 + 2);
+  CHECK(!gpx.empty() && gpx[0].compare(0, 5, "<?xml") == 0);
+  CHECK(gpx.size() == 8 && gpx[7] == "</gpx>\r\n");
+}
+
+TEST(ignores_export_requests_without_a_log) {
+  FixLogger logger;
+  Bridge bridge;
+  CHECK(!logger.begin(LogDevice{nullptr, nullptr, nullptr, nullptr,
+                                nullptr, 0, 16}));
+  logger.requestExport(LogFormat::Nmea);
+  CHECK(!logger.exporting());
+  logger.update(0, bridge);
+  CHECK(!bridge.txPending());
+}
@@ -0,0 +1,145 @@
+#include "fixed_math.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kEarthRadiusDm = 63710088.0;
+
+double rad(int32_t microdegrees) { return microdegrees * 1e-6 * kPi / 180.0; }
+
+double equirectDm(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2) {
+  double dLon = rad(lon2) - rad(lon1);
+  if (dLon > kPi) dLon -= 2 * kPi;
+  if (dLon < -kPi) dLon += 2 * kPi;
+  const double x = dLon * std::cos((rad(lat1) + rad(lat2)) / 2);
+  const double y = rad(lat2) - rad(lat1);
+  return std::sqrt(x * x + y * y) * kEarthRadiusDm;
+}
+
+double haversineDm(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2) {
+  const double sLat = std::sin((rad(lat2) - rad(lat1)) / 2);
+  const double sLon = std::sin((rad(lon2) - rad(lon1)) / 2);
+  const double a =
+      sLat * sLat + std::cos(rad(lat1)) * std::cos(rad(lat2)) * sLon * sLon;
+  return 2 * std::asin(std::sqrt(a)) * kEarthRadiusDm;
+}
+
+// Deterministic pseudo-random numbers so failures reproduce.
+uint32_t g_seed = 12345;
+int32_t randomIn(int32_t lo, int32_t hi) {
+  g_seed = g_seed * 1103515245u + 12345u;
+  return lo + static_cast<int32_t>((g_seed >> 1) % static_cast<uint32_t>(hi - lo + 1));
+}
+
+}  // namespace
+
+TEST(angle_unit_conversions) {
+  // 48 deg 07.03812' N
+  const int32_t nmea = 48 * 6000000 + 703812;
+  const int32_t udeg = nmeaToMicrodegrees(nmea);
+  CHECK(std::fabs(udeg - (48 + 7.03812 / 60) * 1e6) <= 0.5);
+  CHECK_EQ(nmeaToMicrodegrees(-nmea), -udeg);
+  CHECK(std::abs(microdegreesToNmea(udeg) - nmea) <= 3);
+  CHECK_EQ(nmeaToMicrodegrees(180 * 6000000), 180000000);
+}
+
+TEST(formats_nmea_angles) {
+  char buf[16];
+  const int32_t lat = 48 * 6000000 + 703812;
+  uint8_t n = formatNmeaAngle(lat, 2, 5, buf);
+  CHECK_EQ(std::string(buf, n), "4807.03812");
+  n = formatNmeaAngle(-lat, 2, 4, buf);
+  CHECK_EQ(std::string(buf, n), "4807.0381");
+  n = formatNmeaAngle(11 * 6000000 + 3100045, 3, 3, buf);
+  CHECK_EQ(std::string(buf, n), "01131.000");
+  // Rounding that carries into the degrees.
+  n = formatNmeaAngle(5 * 6000000 + 5999999, 2, 4, buf);
+  CHECK_EQ(std::string(buf, n), "0600.0000");
+  n = formatNmeaAngle(0, 3, 0, buf);
+  CHECK_EQ(std::string(buf, n), "00000");
+}
+
+TEST(speed_conversions) {
+  CHECK_EQ(centiKnotsToCentiKmh(1000), 1852u);
+  CHECK_EQ(centiKmhToCentiKnots(1852), 1000u);
+  CHECK_EQ(centiKnotsToCmPerSecond(1000), 514u);
+  CHECK_EQ(cmPerSecondToCentiKnots(514), 999u);
+  CHECK_EQ(cmPerSecondToCentiKnots(1000), 1944u);
+  for (uint32_t ck = 0; ck < 65536; ck += 97) {
+    CHECK(std::fabs(centiKnotsToCentiKmh(ck) - ck * 1.852) <= 0.5);
+    CHECK(std::fabs(centiKnotsToCmPerSecond(ck) - ck * 1852.0 / 3600) <= 0.5);
+  }
+}
+
+TEST(cosine_table_matches_libm) {
+  double worst = 0;
+  for (int32_t a = -90000000; a <= 90000000; a += 123457) {
+    const double err = std::fabs(cosQ15(a) / 32767.0 - std::cos(rad(a)));
+    if (err > worst) worst = err;
+  }
+  CHECK(worst < 1e-4);
+  CHECK_EQ(cosQ15(0), 32767);
+  CHECK_EQ(cosQ15(90000000), 0);
+}
+
+TEST(integer_square_root) {
+  CHECK_EQ(isqrt32(0), 0);
+  CHECK_EQ(isqrt32(1), 1);
+  CHECK_EQ(isqrt32(15), 3);
+  CHECK_EQ(isqrt32(16), 4);
+  CHECK_EQ(isqrt32(0xFFFFFFFFu), 65535);
+  for (uint32_t v = 1; v < 4000000000u; v = v * 3 + 7) {
+    const uint32_t r = isqrt32(v);
+    CHECK(r * r <= v && (r + 1) * (r + 1) > v);
+  }
+}
+
+TEST(distance_matches_double_equirectangular) {
+  double worst = 0;
+  for (int i = 0; i < 20000; ++i) {
+    const int32_t lat1 = randomIn(-80000000, 80000000);
+    const int32_t lon1 = randomIn(-180000000, 180000000);
+    // Mostly short hops, with some long legs.
+    const int32_t span = i % 10 == 0 ? 5000000 : 20000;
+    const int32_t lat2 = lat1 + randomIn(-span, span);
+    int32_t lon2 = lon1 + randomIn(-span, span);
+    if (lon2 > 180000000) lon2 -= 360000000;
+    if (lon2 < -180000000) lon2 += 360000000;
+    const double ref = equirectDm(lat1, lon1, lat2, lon2);
+    const double got = distanceDecimetres(lat1, lon1, lat2, lon2);
+    // 0.1% or, for very short hops, the decimetre resolution.
+    const double err = std::fabs(got - ref) / (ref * 1e-3 + 1.0);
+    if (err > worst) worst = err;
+  }
+  CHECK(worst <= 1.0);
+}
+
+TEST(short_distances_match_great_circle) {
+  // 100 m north at 48 N: 1000 dm.
+  const int32_t lat = 48116000, lon = 11516000;
+  const int32_t north = lat + 899;  // ~100 m
+  const double ref = haversineDm(lat, lon, north, lon);
+  CHECK(std::fabs(distanceDecimetres(lat, lon, north, lon) - ref) <= 1.0);
+  // 1 km east, 1 km north.
+  const int32_t lat2 = lat + 8993, lon2 = lon + 13482;
+  const double ref2 = haversineDm(lat, lon, lat2, lon2);
+  CHECK(std::fabs(distanceDecimetres(lat, lon, lat2, lon2) - ref2) / ref2 <
+        1e-3);
+  CHECK_EQ(distanceDecimetres(lat, lon, lat, lon), 0u);
+}
+
+TEST(distance_across_antimeridian) {
+  const int32_t lat = 10000000;
+  const uint32_t d = distanceDecimetres(lat, 179999000, lat, -179999000);
+  const double ref = equirectDm(lat, 179999000, lat, -179999000);
+  CHECK(std::fabs(d - ref) / ref < 1e-3);
+  CHECK(d < 3000);
+}
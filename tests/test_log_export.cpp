@@ -0,0 +1,145 @@
+#include "log_export.h"
+
+#include <string>
+#include <vector>
+
+#include "nmea_fixtures.h"
+#include "nmea_sentences.h"
+#include "ram_flash.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::nmea;
+
+namespace {
+
+FixRecord sample() {
+  FixRecord r;
+  const UtcDate d = {23, 3, 24};
+  const UtcTime t = {12, 35, 19, 0};
+  r.time = logTime(d, t);
+  r.latitude = 288703812;   // 4807.03812 N
+  r.longitude = -69100045;  // 01131.00045 W
+  r.speed = 2240;
+  r.course = 8440;
+  r.hdop = 94;
+  r.satellites = 8;
+  return r;
+}
+
+std::string line(uint8_t (*format)(const FixRecord&, char*),
+                 const FixRecord& r) {
+  char buf[LogExport::kMaxLine];
+  const uint8_t n = format(r, buf);
+  CHECK(n <= LogExport::kMaxLine);
+  return std::string(buf, n);
+}
+
+bool load(NmeaParser& p, const std::string& s) {
+  bool got = false;
+  for (char c : s) {
+    if (p.feed(static_cast<uint8_t>(c)) == NmeaParser::Status::Sentence) {
+      got = true;
+    }
+  }
+  return got;
+}
+
+std::vector<std::string> exportAll(const FixLog& log, LogFormat format) {
+  LogExport out;
+  out.begin(format);
+  std::vector<std::string> lines;
+  char buf[LogExport::kMaxLine];
+  while (out.active()) {
+    const uint8_t n = out.next(log, buf);
+    if (n) lines.push_back(std::string(buf, n));
+  }
+  return lines;
+}
+
+}  // namespace
+
+TEST(nmea_lines_decode_to_the_record) {
+  const FixRecord r = sample();
+  const std::string rmc = line(&LogExport::formatRmc, r);
+  CHECK_EQ(rmc, nmea("GPRMC,123519.00,A,4807.03812,N,01131.00045,W,22.40,"
+                     "84.40,230324,,,A"));
+  const std::string gga = line(&LogExport::formatGga, r);
+  CHECK_EQ(gga, nmea("GPGGA,123519.00,4807.03812,N,01131.00045,W,1,08,0.94,"
+                     ",M,,M,,"));
+
+  NmeaParser p;
+  CHECK(load(p, rmc));
+  RmcData rd;
+  CHECK(decodeRmc(p, rd));
+  CHECK(rd.valid);
+  CHECK_EQ(logTime(rd.date, rd.time), r.time);
+  CHECK_EQ(rd.latitude, r.latitude);
+  CHECK_EQ(rd.longitude, r.longitude);
+  CHECK_EQ(rd.speed, r.speed);
+  CHECK_EQ(rd.course, r.course);
+  CHECK(load(p, gga));
+  GgaData gd;
+  CHECK(decodeGga(p, gd));
+  CHECK_EQ(gd.satellites, 8);
+  CHECK_EQ(gd.hdop, 94);
+}
+
+TEST(absent_course_and_hdop_stay_empty) {
+  FixRecord r = sample();
+  r.course = kNoValue16;
+  r.hdop = kNoValue16;
+  r.latitude = -r.latitude;
+  CHECK_EQ(line(&LogExport::formatRmc, r),
+           nmea("GPRMC,123519.00,A,4807.03812,S,01131.00045,W,22.40,,"
+                "230324,,,A"));
+  CHECK_EQ(line(&LogExport::formatGga, r),
+           nmea("GPGGA,123519.00,4807.03812,S,01131.00045,W,1,08,,,M,,M,,"));
+  CHECK_EQ(line(&LogExport::formatTrackPoint, r),
+           "<trkpt lat=\"-48.117302\" lon=\"-11.516674\"><time>"
+           "2024-03-23T12:35:19Z</time><sat>8</sat></trkpt>\r\n");
+}
+
+TEST(gpx_is_a_complete_track) {
+  vx8test::RamFlash ram(4, 16);
+  FixLog log;
+  CHECK(log.begin(ram.device()));
+  FixRecord r = sample();
+  for (int i = 0; i < 3; ++i, ++r.time) log.append(r);
+  log.flush();
+  log.update();
+  log.update();
+  const std::vector<std::string> lines = exportAll(log, LogFormat::Gpx);
+  CHECK_EQ(lines.size(), 8u);
+  CHECK_EQ(lines[0], "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
+  CHECK(lines[1].compare(0, 5, "<gpx ") == 0);
+  CHECK_EQ(lines[2], "<trk><trkseg>\r\n");
+  CHECK_EQ(lines[3],
+           "<trkpt lat=\"48.117302\" lon=\"-11.516674\"><time>"
+           "2024-03-23T12:35:19Z</time><sat>8</sat><hdop>0.94</hdop>"
+           "</trkpt>\r\n");
+  CHECK(lines[5].find("12:35:21Z") != std::string::npos);
+  CHECK_EQ(lines[6], "</trkseg></trk>\r\n");
+  CHECK_EQ(lines[7], "</gpx>\r\n");
+}
+
+TEST(nmea_export_is_rmc_then_gga_per_record) {
+  vx8test::RamFlash ram(4, 16);
+  FixLog log;
+  CHECK(log.begin(ram.device()));
+  CHECK(exportAll(log, LogFormat::Nmea).empty());
+  CHECK_EQ(exportAll(log, LogFormat::Gpx).size(), 5u);  // empty track
+  FixRecord r = sample();
+  for (int i = 0; i < 20; ++i, ++r.time) {
+    log.append(r);
+    log.update();
+    log.update();
+  }
+  log.flush();
+  log.update();
+  const std::vector<std::string> lines = exportAll(log, LogFormat::Nmea);
+  CHECK_EQ(lines.size(), 40u);
+  CHECK(lines[0].compare(0, 17, "$GPRMC,123519.00,") == 0);
+  CHECK(lines[1].compare(0, 17, "$GPGGA,123519.00,") == 0);
+  CHECK(lines[39].compare(0, 17, "$GPGGA,123538.00,") == 0);
+}
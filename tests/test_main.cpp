@@ -0,0 +1,38 @@
+#include "test_support.h"
+
+namespace vx8test {
+
+namespace {
+TestCase* g_head = nullptr;
+TestCase* g_tail = nullptr;
+int g_failures = 0;
+}  // namespace
+
+void registerTest(TestCase* tc) {
+  if (g_tail) {
+    g_tail->next = tc;
+  } else {
+    g_head = tc;
+  }
+  g_tail = tc;
+}
+
+void recordFailure(const char* file, int line, const char* expr) {
+  std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+  ++g_failures;
+}
+
+}  // namespace vx8test
+
+int main() {
+  int run = 0;
+  for (vx8test::TestCase* tc = vx8test::g_head; tc; tc = tc->next) {
+    const int before = vx8test::g_failures;
+    tc->fn();
+    std::printf("[%s] %s\n", vx8test::g_failures == before ? " OK " : "FAIL",
+                tc->name);
+    ++run;
+  }
+  std::printf("%d tests, %d failed checks\n", run, vx8test::g_failures);
+  return vx8test::g_failures == 0 ? 0 : 1;
+}
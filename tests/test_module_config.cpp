@@ -0,0 +1,241 @@
+#include "module_config.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nmea_fixtures.h"
+#include "pmtk.h"
+#include "test_support.h"
+
+using namespace vx8;
+using Result = ModuleConfigurator::Result;
+
+namespace {
+
+enum class Kind { Ublox, Mediatek, Silent };
+
+// A GPS module at the other end of the wire. It answers the commands its
+// protocol understands, switches baud when told to, and sends a GGA every
+// second at its current baud rate. Bytes sent at the wrong baud rate are
+// lost in both directions (the host receives line noise).
+class FakeModule {
+ public:
+  FakeModule(Kind kind, uint32_t baud) : kind_(kind), baud_(baud) {}
+
+  uint32_t baud() const { return baud_; }
+  std::map<uint8_t, uint8_t> ubxRates;  // NMEA message id -> rate
+  uint16_t measurementMs = 100;
+  std::string pmtkOutput;
+  uint16_t pmtkInterval = 100;
+  bool nakEverything = false;
+  std::string banner;
+
+  void receive(const uint8_t* data, uint8_t len) {
+    for (uint8_t i = 0; i < len; ++i) {
+      if (kind_ == Kind::Ublox &&
+          ubx_.feed(data[i]) == ubx::Parser::Status::Frame) {
+        onUbx();
+      }
+      if (kind_ == Kind::Mediatek &&
+          nmea_.feed(data[i]) == NmeaParser::Status::Sentence) {
+        onPmtk();
+      }
+    }
+  }
+
+  void tick(uint32_t nowMs) {
+    if (!banner.empty() && nowMs == 0) out += banner;
+    if (nowMs % 1000 == 500) {
+      out += vx8test::nmea("GPGGA,120000.00,,,,,0,00,99.99,,,,,,");
+    }
+  }
+
+  std::string out;  // bytes waiting to go to the host
+
+ private:
+  void ack(uint8_t cls, uint8_t id, bool positive) {
+    const uint8_t p[2] = {cls, id};
+    uint8_t buf[16];
+    const uint8_t n = ubx::encode(ubx::kClassAck,
+                                  positive ? ubx::kIdAckAck : ubx::kIdAckNak,
+                                  p, 2, buf);
+    out.append(reinterpret_cast<char*>(buf), n);
+  }
+
+  void onUbx() {
+    const uint8_t cls = ubx_.msgClass(), id = ubx_.msgId();
+    const uint8_t* p = ubx_.payload();
+    if (cls != ubx::kClassCfg) return;
+    if (nakEverything) {
+      ack(cls, id, false);
+      return;
+    }
+    if (id == ubx::kIdCfgMsg && ubx_.length() == 3) {
+      ubxRates[p[1]] = p[2];
+    } else if (id == ubx::kIdCfgRate && ubx_.length() == 6) {
+      measurementMs = static_cast<uint16_t>(p[0] | (p[1] << 8));
+    } else if (id == ubx::kIdCfgPrt && ubx_.length() == 20) {
+      // Switches immediately; the acknowledgement is lost.
+      baud_ = p[8] | (p[9] << 8) | (uint32_t(p[10]) << 16) |
+              (uint32_t(p[11]) << 24);
+      return;
+    }
+    ack(cls, id, true);
+  }
+
+  void onPmtk() {
+    const NmeaField cmd = nmea_.field(0);
+    std::string reply;
+    if (cmd.equals("PMTK000")) {
+      reply = "PMTK001,0,3";
+    } else if (cmd.equals("PMTK314")) {
+      pmtkOutput = std::string(nmea_.sentence(), nmea_.length()).substr(9, 37);
+      reply = "PMTK001,314,3";
+    } else if (cmd.equals("PMTK220")) {
+      pmtkInterval = static_cast<uint16_t>(std::stoi(std::string(
+          nmea_.field(1).data, nmea_.field(1).len)));
+      reply = "PMTK001,220,3";
+    } else if (cmd.equals("PMTK251")) {
+      baud_ = static_cast<uint32_t>(std::stoul(std::string(
+          nmea_.field(1).data, nmea_.field(1).len)));
+    }
+    if (!reply.empty()) out += vx8test::nmea(reply);
+  }
+
+  Kind kind_;
+  uint32_t baud_;
+  ubx::Parser ubx_;
+  NmeaParser nmea_;
+};
+
+struct Harness {
+  explicit Harness(FakeModule& m)
+      : module(m),
+        config(port(), ModuleConfigOptions::defaults()) {}
+
+  ConfigPort port() {
+    ConfigPort p;
+    p.write = [](void* ctx, const uint8_t* data, uint8_t len) {
+      Harness* h = static_cast<Harness*>(ctx);
+      h->written.insert(h->written.end(), data, data + len);
+      if (h->hostBaud == h->module.baud()) h->module.receive(data, len);
+    };
+    p.setBaud = [](void* ctx, uint32_t baud) {
+      static_cast<Harness*>(ctx)->hostBaud = baud;
+    };
+    p.ctx = this;
+    return p;
+  }
+
+  // Runs in 10 ms steps until the configurator finishes or time runs out.
+  Result run(uint32_t limitMs = 30000) {
+    config.begin(0);
+    for (uint32_t t = 0; t <= limitMs; t += 10) {
+      module.tick(t);
+      for (char c : module.out) {
+        const uint8_t b = hostBaud == module.baud() ? uint8_t(c) : 0xF8;
+        config.onRxByte(b);
+      }
+      module.out.clear();
+      const Result r = config.poll(t);
+      if (r != Result::Pending) {
+        finishedAt = t;
+        return r;
+      }
+    }
+    return Result::Pending;
+  }
+
+  FakeModule& module;
+  ModuleConfigurator config;
+  uint32_t hostBaud = 0;
+  uint32_t finishedAt = 0;
+  std::vector<uint8_t> written;
+};
+
+}  // namespace
+
+TEST(configures_ublox_and_changes_baud) {
+  FakeModule m(Kind::Ublox, 38400);
+  Harness h(m);
+  CHECK(h.run() == Result::Configured);
+  CHECK(h.config.module() == GpsModule::Ublox);
+  CHECK_EQ(h.config.baud(), 9600u);
+  CHECK_EQ(m.baud(), 9600u);
+  CHECK_EQ(h.hostBaud, 9600u);
+  CHECK_EQ(h.config.failures(), 0);
+  CHECK_EQ(m.measurementMs, 1000);
+  CHECK_EQ(m.ubxRates[ubx::kNmeaGga], 1);
+  CHECK_EQ(m.ubxRates[ubx::kNmeaRmc], 1);
+  CHECK_EQ(m.ubxRates[ubx::kNmeaGsv], 1);
+  CHECK_EQ(m.ubxRates[ubx::kNmeaVtg], 0);
+  CHECK_EQ(m.ubxRates[ubx::kNmeaGll], 0);
+  CHECK_EQ(m.ubxRates.size(), 12u);
+}
+
+TEST(ublox_transcript_starts_with_probe_then_messages) {
+  FakeModule m(Kind::Ublox, 9600);
+  Harness h(m);
+  CHECK(h.run() == Result::Configured);
+  // Poll CFG-RATE, then CFG-MSG for GGA on.
+  const std::vector<uint8_t> head = {0xB5, 0x62, 0x06, 0x08, 0x00, 0x00,
+                                     0x0E, 0x30, 0xB5, 0x62, 0x06, 0x01,
+                                     0x03, 0x00, 0xF0, 0x00, 0x01};
+  CHECK(h.written.size() > head.size());
+  CHECK(std::vector<uint8_t>(h.written.begin(),
+                             h.written.begin() + long(head.size())) == head);
+  // Already at the target baud: no CFG-PRT is sent.
+  const std::vector<uint8_t> tail = {0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xE8,
+                                     0x03, 0x01, 0x00, 0x01, 0x00, 0x01, 0x39};
+  CHECK(std::vector<uint8_t>(h.written.end() - long(tail.size()),
+                             h.written.end()) == tail);
+}
+
+TEST(configures_mediatek) {
+  FakeModule m(Kind::Mediatek, 115200);
+  Harness h(m);
+  CHECK(h.run() == Result::Configured);
+  CHECK(h.config.module() == GpsModule::Mediatek);
+  CHECK_EQ(m.baud(), 9600u);
+  CHECK_EQ(h.hostBaud, 9600u);
+  CHECK_EQ(m.pmtkInterval, 1000);
+  CHECK_EQ(m.pmtkOutput, "0,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0");
+  // Without a banner the UBX probe goes first and times out.
+  CHECK_EQ(h.written[0], ubx::kSync1);
+}
+
+TEST(boot_banner_picks_probe_order) {
+  FakeModule m(Kind::Mediatek, 9600);
+  m.banner = vx8test::nmea("PMTK011,MTKGPS");
+  Harness h(m);
+  CHECK(h.run() == Result::Configured);
+  const std::string start(h.written.begin(), h.written.begin() + 13);
+  CHECK_EQ(start, "$PMTK000*32\r\n");
+}
+
+TEST(unknown_module_is_left_alone) {
+  FakeModule m(Kind::Silent, 4800);
+  Harness h(m);
+  CHECK(h.run() == Result::Unidentified);
+  CHECK(h.config.module() == GpsModule::Unknown);
+  CHECK_EQ(h.config.baud(), 4800u);
+  CHECK_EQ(h.hostBaud, 4800u);
+}
+
+TEST(no_module_reports_no_signal) {
+  FakeModule m(Kind::Silent, 1);  // never matches a candidate
+  Harness h(m);
+  CHECK(h.run() == Result::NoSignal);
+  CHECK_EQ(h.hostBaud, 9600u);
+  CHECK(h.finishedAt < 6 * 1600u);
+}
+
+TEST(refused_commands_give_partial_result) {
+  FakeModule m(Kind::Ublox, 9600);
+  m.nakEverything = true;
+  Harness h(m);
+  CHECK(h.run() == Result::Partial);
+  CHECK(h.config.module() == GpsModule::Ublox);
+  CHECK_EQ(h.config.failures(), 13);
+}
@@ -0,0 +1,130 @@
+#include "monitor.h"
+
+#include <string>
+
+#include "filter_chain.h"
+#include "nmea_fixtures.h"
+#include "output_profile.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::nmea;
+
+namespace {
+
+struct Device {
+  Monitor monitor;
+  OutputProfile profile;
+  FilterChain chain;
+  Bridge bridge;
+
+  Device() {
+    chain.add(&Monitor::filter, &monitor);
+    chain.add(&OutputProfile::filter, &profile);
+    bridge.setFilter(&FilterChain::filter, &chain);
+  }
+
+  // One main-loop pass at `nowMs`; returns what went out on TX.
+  std::string loop(uint32_t nowMs, const std::string& in = "") {
+    std::string out;
+    uint8_t b;
+    for (size_t i = 0; i < in.size(); ++i) {
+      bridge.onRxByte(static_cast<uint8_t>(in[i]));
+      if (i % 64 == 63) {
+        bridge.poll();
+        while (bridge.nextTxByte(b)) out.push_back(static_cast<char>(b));
+      }
+    }
+    bridge.poll();
+    monitor.update(nowMs, bridge);
+    while (bridge.nextTxByte(b)) out.push_back(static_cast<char>(b));
+    return out;
+  }
+};
+
+std::string noFix() { return nmea("GPGGA,083000.00,,,,,0,00,99.99,,,,,,"); }
+
+}  // namespace
+
+TEST(formats_both_report_parts) {
+  Counters c = {};
+  c.bytesIn = 4294967295u;
+  c.bytesOut = 1200;
+  c.rxOverruns = 3;
+  c.txQueueFull = 0;
+  c.sentencesForwarded = 65535;
+  c.checksumErrors = 7;
+  c.parseErrors = 9;
+  c.sentencesFiltered = 41;
+  c.fixAgeS = 12;
+  c.maxLoopUs = 850;
+  char buf[Monitor::kMaxReport];
+  uint8_t n = Monitor::formatReport(c, 1, buf);
+  CHECK_EQ(std::string(buf, n), nmea("PVX8S,1,4294967295,1200,3,0,65535"));
+  n = Monitor::formatReport(c, 2, buf);
+  CHECK_EQ(std::string(buf, n), nmea("PVX8S,2,7,9,41,12,850"));
+  c.fixAgeS = Counters::kNoFix;
+  c.maxLoopUs = 4294967295u;
+  c.checksumErrors = c.parseErrors = c.sentencesFiltered = 65535;
+  n = Monitor::formatReport(c, 2, buf);
+  CHECK_EQ(std::string(buf, n), nmea("PVX8S,2,65535,65535,65535,,4294967295"));
+  CHECK(n <= Monitor::kMaxReport);
+}
+
+TEST(query_is_answered_between_sentences) {
+  Device d;
+  std::string bad = nmea("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+  bad[bad.size() - 3] = bad[bad.size() - 3] == '0' ? '1' : '0';
+  const std::string epoch = vx8test::gpsEpoch(8, 30, 0);
+  d.loop(1000, epoch + bad + "$GPGGA,garbage\r\n");
+
+  std::string out = d.loop(1500, nmea("PVX8Q"));
+  CHECK(d.monitor.reportPending());
+  out += d.loop(1600);
+  CHECK(!d.monitor.reportPending());
+  CHECK_EQ(d.monitor.queries(), 1);
+  const std::string in = epoch + bad + "$GPGGA,garbage\r\n" + nmea("PVX8Q");
+  // The query itself is swallowed, not forwarded.
+  const Counters c = d.monitor.snapshot(1600, d.bridge);
+  CHECK_EQ(c.bytesIn, in.size());
+  CHECK_EQ(c.checksumErrors, 1);
+  CHECK_EQ(c.parseErrors, 2);
+  CHECK_EQ(c.sentencesForwarded, 5);
+  CHECK_EQ(c.sentencesFiltered, 1);
+  CHECK_EQ(out, nmea("PVX8S,1," + std::to_string(in.size()) + "," +
+                     std::to_string(d.bridge.stats().bytesOut - out.size()) +
+                     ",0,0,5") +
+                    nmea("PVX8S,2,1,2,1,0,0"));
+}
+
+TEST(fix_age_counts_from_the_last_valid_fix) {
+  Device d;
+  CHECK_EQ(d.monitor.snapshot(0, d.bridge).fixAgeS, Counters::kNoFix);
+  d.loop(1000, vx8test::gpsEpoch(8, 30, 0));
+  d.loop(2000, noFix());
+  d.loop(3000, nmea("GPRMC,083003.00,V,,,,,,,230394,,,N"));
+  CHECK_EQ(d.monitor.snapshot(6999, d.bridge).fixAgeS, 5);
+  d.loop(7000, vx8test::gpsEpoch(8, 30, 7));
+  CHECK_EQ(d.monitor.snapshot(7000, d.bridge).fixAgeS, 0);
+  CHECK_EQ(d.monitor.snapshot(7000 + 70000000u, d.bridge).fixAgeS, 65534);
+}
+
+TEST(keeps_the_longest_loop_pass) {
+  Monitor m;
+  m.beginLoop(100);
+  m.endLoop(400);
+  m.beginLoop(0xFFFFFF00u);  // micros() wraps after 71 minutes
+  m.endLoop(0x100);
+  m.beginLoop(1000);
+  m.endLoop(1010);
+  CHECK_EQ(m.maxLoopUs(), 0x200u);
+}
+
+TEST(report_can_be_requested_locally) {
+  Device d;
+  d.monitor.requestReport();
+  std::string out = d.loop(0);
+  out += d.loop(1);
+  CHECK_EQ(out.compare(0, 9, "$PVX8S,1,"), 0);
+  CHECK(out.find("$PVX8S,2,") != std::string::npos);
+}
@@ -0,0 +1,254 @@
+#include "motion_filter.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::nmea;
+
+namespace {
+
+// Latitude 48 deg N, longitude 11 deg E, in 1e-5 arc-minutes.
+const int32_t kLat = 48 * 6000000 + 703812;
+const int32_t kLon = 11 * 6000000 + 3100045;
+// About one metre of latitude.
+const int32_t kMetre = 54;
+
+std::string angle(int32_t v, int degreeDigits) {
+  const int32_t m = v < 0 ? -v : v;
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%0*d%02d.%05d", degreeDigits,
+                int(m / 6000000), int(m / 100000 % 60), int(m % 100000));
+  return buf;
+}
+
+struct Fix {
+  int second;
+  int32_t lat;
+  int32_t lon;
+  std::string speed;
+  std::string course;
+  std::string hdop;
+};
+
+std::string epoch(const Fix& f) {
+  char t[32];
+  std::snprintf(t, sizeof(t), "12%02d%02d.00", f.second / 60, f.second % 60);
+  const std::string pos = angle(f.lat, 2) + (f.lat < 0 ? ",S," : ",N,") +
+                          angle(f.lon, 3) + ",E";
+  return nmea("GPGGA," + std::string(t) + "," + pos + ",1,08," + f.hdop +
+              ",545.4,M,46.9,M,,") +
+         nmea("GPRMC," + std::string(t) + ",A," + pos + "," + f.speed + "," +
+              f.course + ",230394,,,A");
+}
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> out(1);
+  for (char c : s) {
+    if (c == ',' || c == '*') {
+      out.emplace_back();
+    } else {
+      out.back().push_back(c);
+    }
+  }
+  return out;
+}
+
+// Runs input through a bridge filtered by `filter` and returns the radio's
+// sentences split into fields, checking every checksum.
+std::vector<std::vector<std::string>> run(MotionFilter& filter,
+                                          const std::string& input) {
+  const std::string out =
+      vx8test::forward(&MotionFilter::filter, &filter, input);
+  std::vector<std::vector<std::string>> result;
+  NmeaParser p;
+  for (char c : out) {
+    const NmeaParser::Status st = p.feed(static_cast<uint8_t>(c));
+    CHECK(st != NmeaParser::Status::Error);
+    if (st == NmeaParser::Status::Sentence) result.push_back(split(p.sentence()));
+  }
+  return result;
+}
+
+// Stationary jitter: a few metres either way, slow noisy speed and course.
+std::string jitter(int first, int count) {
+  static const int kOffsets[] = {0, 3, -2, 4, -4, 1, -3, 2, 5, -1};
+  static const char* kCourses[] = {"12.30", "201.70", "95.00", "330.10"};
+  std::string in;
+  for (int i = 0; i < count; ++i) {
+    const int32_t d = kOffsets[i % 10] * kMetre;
+    in += epoch({first + i, kLat + d, kLon - d, "0.3" + std::to_string(i % 7),
+                 kCourses[i % 4], "0.94"});
+  }
+  return in;
+}
+
+}  // namespace
+
+TEST(stationary_jitter_is_held) {
+  MotionFilter f;
+  const auto out = run(f, jitter(0, 20));
+  CHECK_EQ(out.size(), 40u);
+  CHECK(f.holding());
+  // From the third epoch on every fix reports the same position.
+  for (size_t i = 6; i < out.size(); ++i) {
+    const size_t lat = out[i][0] == "$GPGGA" ? 2 : 3;
+    CHECK_EQ(out[i][lat], out[4][2]);
+    CHECK_EQ(out[i][lat + 2], out[4][4]);
+  }
+  CHECK_EQ(out.back()[0], "$GPRMC");
+  CHECK_EQ(out.back()[7], "0.00");
+  CHECK_EQ(out.back()[8], "330.10");  // no course above 2 kn yet
+}
+
+TEST(both_sentences_of_an_epoch_agree) {
+  MotionFilter f;
+  std::string in;
+  for (int s = 0; s < 10; ++s) {
+    in += epoch({s, kLat + s * 500 + (s % 2) * 100, kLon, "18.00", "0.00",
+                 "0.94"});
+  }
+  const auto out = run(f, in);
+  CHECK_EQ(out.size(), 20u);
+  for (size_t i = 0; i < out.size(); i += 2) {
+    CHECK_EQ(out[i][2], out[i + 1][3]);
+    CHECK_EQ(out[i][4], out[i + 1][5]);
+  }
+}
+
+TEST(steady_movement_is_tracked_without_lag) {
+  MotionFilter f;
+  // 500 units/s is about 9 m/s: 18 knots due north.
+  std::string in = jitter(0, 5);
+  for (int s = 5; s < 40; ++s) {
+    in += epoch({s, kLat + (s - 5) * 500, kLon, "18.00", "0.00", "0.94"});
+  }
+  run(f, in);
+  CHECK(!f.holding());
+  const int32_t err = f.latitude() - (kLat + 34 * 500);
+  CHECK(err < 2 * kMetre && err > -2 * kMetre);
+  CHECK(f.longitude() - kLon < kMetre && kLon - f.longitude() < kMetre);
+}
+
+TEST(smoothing_reduces_jitter_while_moving) {
+  MotionFilter f;
+  std::string in;
+  int32_t rawError = 0, outError = 0;
+  for (int s = 0; s < 30; ++s) {
+    const int32_t truth = kLat + s * 500;
+    const int32_t noise = (s % 2 ? 8 : -8) * kMetre;
+    in += epoch({s, truth + noise, kLon, "18.00", "0.00", "0.94"});
+  }
+  const auto out = run(f, in);
+  for (int s = 10; s < 30; ++s) {
+    const int32_t truth = kLat + s * 500;
+    const std::string& lat = out[2 * s][2];
+    const int32_t got = std::stoi(lat.substr(0, 2)) * 6000000 +
+                        std::stoi(lat.substr(2, 2)) * 100000 +
+                        std::stoi(lat.substr(5));
+    rawError += 8 * kMetre;
+    outError += got > truth ? got - truth : truth - got;
+  }
+  CHECK(outError * 2 < rawError);
+}
+
+TEST(moving_fixes_release_the_hold) {
+  MotionFilter f;
+  std::string in = jitter(0, 10);
+  for (int s = 10; s < 13; ++s) {
+    in += epoch({s, kLat + (s - 9) * 500, kLon, "18.00", "0.00", "0.94"});
+  }
+  const auto out = run(f, in);
+  CHECK(!f.holding());
+  // GGA comes first here and so goes by the previous RMC's speed: the hold
+  // ends with the second fast RMC, and the GGA after it.
+  CHECK_EQ(out[2 * 11][2], out[2 * 9][2]);
+  CHECK_EQ(out[2 * 11 + 1][3], out[2 * 9][2]);
+  CHECK_EQ(out[2 * 11 + 1][7], "00.00");
+  CHECK(out[2 * 12][2] != out[2 * 9][2]);
+  CHECK_EQ(out[2 * 12 + 1][7], "18.00");
+}
+
+TEST(slow_drift_releases_the_hold) {
+  MotionFilter f;
+  // 0.8 kn, below the hold speed: 41 cm/s, or 22 units/s.
+  std::string in;
+  for (int s = 0; s < 300; ++s) {
+    in += epoch({s, kLat + s * 22, kLon, "0.80", "0.00", "0.94"});
+  }
+  const auto out = run(f, in);
+  std::vector<std::string> positions;
+  for (size_t i = 0; i < out.size(); i += 2) {
+    if (positions.empty() || positions.back() != out[i][2]) {
+      positions.push_back(out[i][2]);
+    }
+  }
+  // Held most of the time, but the position steps forward every ~25 m.
+  CHECK(positions.size() >= 4u);
+  CHECK(positions.size() <= 40u);
+}
+
+TEST(poor_hdop_never_counts_as_movement) {
+  MotionFilter f;
+  std::string in = jitter(0, 10);
+  for (int s = 10; s < 20; ++s) {
+    in += epoch({s, kLat + (s - 9) * 300, kLon, "11.00", "0.00", "9.90"});
+  }
+  run(f, in);
+  CHECK(f.holding());
+}
+
+TEST(course_is_held_below_heading_speed) {
+  MotionFilter f;
+  std::string in;
+  for (int s = 0; s < 5; ++s) {
+    in += epoch({s, kLat + s * 500, kLon, "10.00", "84.40", "0.94"});
+  }
+  in += epoch({5, kLat + 2600, kLon, "1.50", "271.30", "0.94"});
+  in += epoch({6, kLat + 2700, kLon, "1.20", "5.20", "0.94"});
+  in += epoch({7, kLat + 2800, kLon, "1.10", "", "0.94"});
+  const auto out = run(f, in);
+  CHECK_EQ(out[9][8], "84.40");
+  CHECK_EQ(out[11][8], "084.40");
+  CHECK_EQ(out[13][8], "84.4");  // narrower field, fewer decimals
+  CHECK_EQ(out[15][8], "");
+}
+
+TEST(hemisphere_follows_the_held_position) {
+  MotionFilter f;
+  std::string in;
+  for (int s = 0; s < 10; ++s) {
+    const int32_t lat = (s % 2 ? 1 : -1) * 2 * kMetre + (s == 0 ? -kMetre : 0);
+    in += epoch({s, lat, kLon, "0.10", "0.00", "0.94"});
+  }
+  const auto out = run(f, in);
+  CHECK(f.holding());
+  for (size_t i = 6; i < out.size(); i += 2) {
+    CHECK_EQ(out[i][3], out[4][3]);
+    CHECK_EQ(out[i][2], out[4][2]);
+  }
+}
+
+TEST(fixes_without_a_position_pass_through) {
+  MotionFilter f;
+  const std::string in =
+      nmea("GPRMC,120000.00,V,,,,,,,230394,,,N") +
+      nmea("GPGGA,120000.00,,,,,0,00,99.99,,,,,,") +
+      nmea("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+  const auto out = run(f, in);
+  CHECK_EQ(out.size(), 3u);
+  CHECK(!f.holding());
+}
+
+TEST(a_gap_restarts_the_tracker) {
+  MotionFilter f;
+  std::string in = jitter(0, 10);
+  in += epoch({40, kLat + 1000 * kMetre, kLon, "0.10", "0.00", "0.94"});
+  const auto out = run(f, in);
+  CHECK(!f.holding());
+  CHECK_EQ(out.back()[3], angle(kLat + 1000 * kMetre, 2));
+}
@@ -0,0 +1,131 @@
+#include "nmea_parser.h"
+
+#include <cstring>
+#include <string>
+
+#include "test_support.h"
+
+using vx8::NmeaParser;
+using Status = vx8::NmeaParser::Status;
+
+namespace {
+
+const char kGga[] =
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+
+// Feeds a string and returns the last non-Busy status, counting how many
+// sentences and errors were reported along the way.
+Status feedAll(NmeaParser& p, const char* s, int* sentences = nullptr,
+               int* errors = nullptr) {
+  Status last = Status::Busy;
+  for (; *s; ++s) {
+    const Status st = p.feed(static_cast<uint8_t>(*s));
+    if (st != Status::Busy) last = st;
+    if (st == Status::Sentence && sentences) ++*sentences;
+    if (st == Status::Error && errors) ++*errors;
+  }
+  return last;
+}
+
+}  // namespace
+
+TEST(parses_valid_sentence) {
+  NmeaParser p;
+  int sentences = 0;
+  feedAll(p, kGga, &sentences);
+  CHECK_EQ(sentences, 1);
+  CHECK(p.talker() == vx8::Talker::GP);
+  CHECK(p.type() == vx8::SentenceType::GGA);
+  CHECK_EQ(p.length(), std::strlen(kGga) - 2);
+  CHECK(std::strncmp(p.sentence(), kGga, p.length()) == 0);
+  CHECK_EQ(p.fieldCount(), 15);
+  CHECK(p.field(0).equals("GPGGA"));
+  CHECK(p.field(2).equals("4807.038"));
+  CHECK(p.field(13).empty());
+  CHECK(p.field(14).empty());
+  CHECK_EQ(p.fieldOffset(1), 7);
+  CHECK_EQ(p.sentence()[p.checksumOffset()], '*');
+}
+
+TEST(rejects_bad_checksum) {
+  NmeaParser p;
+  const char bad[] =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n";
+  int sentences = 0, errors = 0;
+  feedAll(p, bad, &sentences, &errors);
+  CHECK_EQ(sentences, 0);
+  CHECK_EQ(errors, 1);
+  CHECK(p.lastError() == NmeaParser::Error::Checksum);
+}
+
+TEST(accepts_lowercase_checksum_and_bare_lf) {
+  NmeaParser p;
+  int sentences = 0;
+  feedAll(p, "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,"
+             "003.1,W*6a\n",
+          &sentences);
+  CHECK_EQ(sentences, 1);
+  CHECK(p.type() == vx8::SentenceType::RMC);
+}
+
+TEST(missing_checksum_is_an_error) {
+  NmeaParser p;
+  CHECK(feedAll(p, "$GPGGA,123519\r\n") == Status::Error);
+  CHECK(p.lastError() == NmeaParser::Error::MissingChecksum);
+}
+
+TEST(resyncs_on_dollar_mid_sentence) {
+  NmeaParser p;
+  int sentences = 0, errors = 0;
+  feedAll(p, "$GPGGA,1235", &sentences, &errors);
+  feedAll(p, kGga, &sentences, &errors);
+  CHECK_EQ(errors, 1);
+  CHECK_EQ(sentences, 1);
+  CHECK(p.field(1).equals("123519"));
+}
+
+TEST(ignores_noise_between_sentences) {
+  NmeaParser p;
+  int sentences = 0, errors = 0;
+  feedAll(p, "\xB5\x62garbage\r\n", &sentences, &errors);
+  feedAll(p, kGga, &sentences, &errors);
+  feedAll(p, kGga, &sentences, &errors);
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(sentences, 2);
+}
+
+TEST(rejects_overlong_sentence) {
+  NmeaParser p;
+  char longSentence[120] = "$GPXXX,";
+  std::memset(longSentence + 7, 'A', 90);
+  std::strcat(longSentence, "*00\r\n");
+  CHECK(feedAll(p, longSentence) == Status::Error);
+  CHECK(p.lastError() == NmeaParser::Error::Overflow);
+}
+
+TEST(rejects_control_characters) {
+  NmeaParser p;
+  CHECK(feedAll(p, "$GPGGA,12\x01") == Status::Error);
+  CHECK(p.lastError() == NmeaParser::Error::BadCharacter);
+}
+
+TEST(classifies_talkers) {
+  NmeaParser p;
+  feedAll(p, "$GNGGA,,,,,,0,00,,,M,,M,,*78\r\n");
+  CHECK(p.talker() == vx8::Talker::GN);
+  CHECK(p.type() == vx8::SentenceType::GGA);
+  feedAll(p, "$PMTK001,314,3*36\r\n");
+  CHECK(p.type() == vx8::SentenceType::Proprietary);
+}
+
+TEST(checksum_formatting) {
+  char out[2];
+  vx8::formatChecksum(0x4A, out);
+  CHECK(out[0] == '4' && out[1] == 'A');
+}
+
+TEST(finishes_outgoing_sentences) {
+  char buf[32] = "$PMTK220,1000";
+  const uint8_t n = vx8::finishSentence(buf, 13);
+  CHECK_EQ(std::string(buf, n), "$PMTK220,1000*1F\r\n");
+}
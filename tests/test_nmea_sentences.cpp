@@ -0,0 +1,165 @@
+#include "nmea_sentences.h"
+
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+bool load(NmeaParser& p, const char* s) {
+  bool got = false;
+  for (; *s; ++s) {
+    if (p.feed(static_cast<uint8_t>(*s)) == NmeaParser::Status::Sentence) {
+      got = true;
+    }
+  }
+  return got;
+}
+
+NmeaField makeField(const char* s) {
+  NmeaField f;
+  f.data = s;
+  f.len = 0;
+  while (s[f.len]) ++f.len;
+  return f;
+}
+
+}  // namespace
+
+TEST(fixed_point_fields) {
+  int32_t v;
+  CHECK(parseFixed(makeField("545.4"), 1, v) && v == 5454);
+  CHECK(parseFixed(makeField("0.9"), 2, v) && v == 90);
+  CHECK(parseFixed(makeField("022.456"), 2, v) && v == 2245);
+  CHECK(parseFixed(makeField("-12"), 1, v) && v == -120);
+  CHECK(!parseFixed(makeField(""), 1, v));
+  CHECK(!parseFixed(makeField("1a"), 1, v));
+}
+
+TEST(fixed_point_rejects_bare_signs_and_overflow) {
+  int32_t v;
+  CHECK(!parseFixed(makeField("-"), 1, v));
+  CHECK(!parseFixed(makeField("."), 2, v));
+  CHECK(!parseFixed(makeField("-."), 2, v));
+  CHECK(parseFixed(makeField(".5"), 1, v) && v == 5);
+  CHECK(parseFixed(makeField("214748364.7"), 1, v) && v == 2147483647L);
+  CHECK(!parseFixed(makeField("214748364.8"), 1, v));
+  CHECK(!parseFixed(makeField("999999999.9"), 1, v));
+  CHECK(!parseFixed(makeField("21474837"), 2, v));
+  CHECK(parseFixed(makeField("-21474836.47"), 2, v) && v == -2147483647L);
+}
+
+TEST(angles) {
+  int32_t v;
+  CHECK(parseAngle(makeField("4807.038"), makeField("N"), v));
+  CHECK_EQ(v, 48 * 6000000L + 703800L);
+  CHECK(parseAngle(makeField("01131.00012"), makeField("W"), v));
+  CHECK_EQ(v, -(11 * 6000000L + 3100012L));
+  CHECK(!parseAngle(makeField("4807.038"), makeField("X"), v));
+  CHECK(!parseAngle(makeField("4860.000"), makeField("N"), v));
+}
+
+TEST(gga) {
+  NmeaParser p;
+  CHECK(load(p, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,"
+                "M,,*47\r\n"));
+  GgaData g;
+  CHECK(decodeGga(p, g));
+  CHECK_EQ(g.time.hour, 12);
+  CHECK_EQ(g.time.minute, 35);
+  CHECK_EQ(g.time.second, 19);
+  CHECK_EQ(g.time.secondOfDay(), 12 * 3600UL + 35 * 60 + 19);
+  CHECK(g.hasPosition);
+  CHECK_EQ(g.latitude, 48 * 6000000L + 703800L);
+  CHECK_EQ(g.longitude, 11 * 6000000L + 3100000L);
+  CHECK_EQ(g.quality, 1);
+  CHECK_EQ(g.satellites, 8);
+  CHECK_EQ(g.hdop, 90);
+  CHECK_EQ(g.altitude, 5454);
+}
+
+TEST(gga_without_fix) {
+  NmeaParser p;
+  CHECK(load(p, "$GNGGA,000012.00,,,,,0,00,99.99,,,,,,*7B\r\n"));
+  GgaData g;
+  CHECK(decodeGga(p, g));
+  CHECK(!g.hasPosition);
+  CHECK_EQ(g.quality, 0);
+  CHECK_EQ(g.hdop, 9999);
+}
+
+TEST(rmc) {
+  NmeaParser p;
+  CHECK(load(p, "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,"
+                "003.1,W*6A\r\n"));
+  RmcData r;
+  CHECK(decodeRmc(p, r));
+  CHECK(r.valid);
+  CHECK(r.hasPosition);
+  CHECK_EQ(r.speed, 2240);
+  CHECK_EQ(r.course, 8440);
+  CHECK_EQ(r.date.day, 23);
+  CHECK_EQ(r.date.month, 3);
+  CHECK_EQ(r.date.year, 94);
+}
+
+TEST(dates_out_of_range_are_rejected) {
+  UtcDate d;
+  CHECK(parseDate(makeField("290224"), d) && d.day == 29 && d.month == 2);
+  CHECK(!parseDate(makeField("000394"), d));
+  CHECK(!parseDate(makeField("320394"), d));
+  CHECK(!parseDate(makeField("230094"), d));
+  CHECK(!parseDate(makeField("231394"), d));
+  CHECK(!parseDate(makeField(""), d));
+}
+
+TEST(negative_course_and_hdop_are_absent) {
+  NmeaParser p;
+  CHECK(load(p, vx8test::nmea("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,"
+                              "-084.4,230394,003.1,W").c_str()));
+  RmcData r;
+  CHECK(decodeRmc(p, r));
+  CHECK_EQ(r.course, kNoValue16);
+  CHECK(load(p, vx8test::nmea("GPGGA,123519,4807.038,N,01131.000,E,1,08,"
+                              "-0.9,545.4,M,46.9,M,,").c_str()));
+  GgaData g;
+  CHECK(decodeGga(p, g));
+  CHECK_EQ(g.hdop, kNoValue16);
+}
+
+TEST(gsa) {
+  NmeaParser p;
+  CHECK(load(p, "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n"));
+  GsaData a;
+  CHECK(decodeGsa(p, a));
+  CHECK_EQ(a.mode, 'A');
+  CHECK_EQ(a.fixType, 3);
+  CHECK_EQ(a.prnCount, 5);
+  CHECK_EQ(a.prns[4], 24);
+  CHECK_EQ(a.pdop, 250);
+  CHECK_EQ(a.hdop, 130);
+  CHECK_EQ(a.vdop, 210);
+}
+
+TEST(gsv) {
+  NmeaParser p;
+  CHECK(load(p, "$GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,"
+                "228,45*75\r\n"));
+  GsvData v;
+  CHECK(decodeGsv(p, v));
+  CHECK_EQ(v.totalMessages, 2);
+  CHECK_EQ(v.messageNumber, 1);
+  CHECK_EQ(v.satellitesInView, 8);
+  CHECK_EQ(v.count, 4);
+  CHECK_EQ(v.sats[3].prn, 14);
+  CHECK_EQ(v.sats[3].azimuth, 228);
+  CHECK_EQ(v.sats[3].snr, 45);
+}
+
+TEST(decoder_rejects_wrong_type) {
+  NmeaParser p;
+  CHECK(load(p, "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n"));
+  GgaData g;
+  CHECK(!decodeGga(p, g));
+}
@@ -0,0 +1,131 @@
+#include "output_profile.h"
+
+#include <string>
+#include <vector>
+
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using namespace vx8;
+using vx8test::nmea;
+
+namespace {
+
+// Runs input through a bridge filtered by `profile` and returns the output.
+std::string run(OutputProfile& profile, const std::string& input) {
+  return vx8test::forward(&OutputProfile::filter, &profile, input);
+}
+
+// Splits radio output into sentences, checking every checksum.
+std::vector<std::string> sentences(const std::string& out, int* errors) {
+  std::vector<std::string> result;
+  NmeaParser p;
+  for (char c : out) {
+    const NmeaParser::Status st = p.feed(static_cast<uint8_t>(c));
+    if (st == NmeaParser::Status::Sentence) result.emplace_back(p.sentence());
+    if (st == NmeaParser::Status::Error) ++*errors;
+  }
+  return result;
+}
+
+std::string tenHz(int seconds) {
+  std::string in;
+  for (int s = 0; s < seconds; ++s) {
+    for (int cs = 0; cs < 100; cs += 10) in += vx8test::gnssEpoch(10, 0, s, cs);
+  }
+  return in;
+}
+
+}  // namespace
+
+TEST(reduces_multi_gnss_10hz_to_gps_1hz) {
+  OutputProfile profile;
+  const std::string in = tenHz(3);
+  const std::string out = run(profile, in);
+  int errors = 0;
+  const std::vector<std::string> got = sentences(out, &errors);
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(got.size(), 3u * 6u);  // RMC GGA GSA GSV GSV GSV per second
+  for (const std::string& s : got) CHECK(s.compare(0, 3, "$GP") == 0);
+  CHECK(got[0].compare(0, 17, "$GPRMC,100000.00,") == 0);
+  CHECK(got[1].compare(0, 6, "$GPGGA") == 0);
+  CHECK(got[2].compare(0, 6, "$GPGSA") == 0);
+  CHECK(got[6].compare(0, 17, "$GPRMC,100001.00,") == 0);
+  // Input is over ten times what the radio now has to receive.
+  CHECK(out.size() * 10 < in.size());
+}
+
+TEST(rewrites_talker_and_strips_nmea41_fields) {
+  OutputProfile profile;
+  const std::string out = run(profile, vx8test::gnssEpoch(10, 0, 0, 0));
+  int errors = 0;
+  const std::vector<std::string> got = sentences(out, &errors);
+  CHECK_EQ(errors, 0);
+  CHECK(got.size() == 6u);
+  CHECK(got[0] + "\r\n" ==
+        nmea("GPRMC,100000.00,A,4807.03812,N,01131.00045,E,0.012,,230394,,,A"));
+  CHECK(got[2] + "\r\n" == nmea("GPGSA,A,3,04,05,09,12,24,,,,,,,,1.32,0.71,1.11"));
+}
+
+TEST(caps_gsv_satellites) {
+  OutputProfile profile;
+  const std::string out = run(profile, vx8test::gnssEpoch(10, 0, 0, 0));
+  int errors = 0;
+  const std::vector<std::string> got = sentences(out, &errors);
+  CHECK(got.size() == 6u);
+  CHECK(got[3] + "\r\n" ==
+        nmea("GPGSV,3,1,12,01,40,083,46,02,17,308,41,04,07,344,39,05,22,228,45"));
+  CHECK(got[5].compare(0, 13, "$GPGSV,3,3,12") == 0);
+}
+
+TEST(caps_gsv_mid_message) {
+  ProfileConfig config = ProfileConfig::defaults();
+  config.maxGsvSatellites = 10;
+  OutputProfile profile(config);
+  const std::string out = run(profile, vx8test::gnssEpoch(10, 0, 0, 0));
+  int errors = 0;
+  const std::vector<std::string> got = sentences(out, &errors);
+  CHECK_EQ(errors, 0);
+  CHECK(got.size() == 6u);
+  CHECK(got[5] + "\r\n" == nmea("GPGSV,3,3,10,19,12,101,31,22,55,041,44"));
+}
+
+TEST(sentence_set_is_configurable) {
+  ProfileConfig config = ProfileConfig::defaults();
+  config.sentences = VX8_SENTENCE_GGA | VX8_SENTENCE_RMC;
+  OutputProfile profile(config);
+  int errors = 0;
+  const std::vector<std::string> got =
+      sentences(run(profile, tenHz(2)), &errors);
+  CHECK(got.size() == 4u);
+}
+
+TEST(passes_everything_through_at_module_rate_when_not_decimating) {
+  ProfileConfig config = ProfileConfig::defaults();
+  config.oneHz = false;
+  OutputProfile profile(config);
+  int errors = 0;
+  const std::vector<std::string> got =
+      sentences(run(profile, tenHz(1)), &errors);
+  CHECK(got.size() == 10u * 6u);
+}
+
+TEST(decimates_before_utc_is_known) {
+  OutputProfile profile;
+  std::string in;
+  for (int i = 0; i < 30; ++i) {
+    in += nmea("GNRMC,,V,,,,,,,,,,N,V");
+    in += nmea("GNGGA,,,,,,0,00,99.99,,,,,,");
+  }
+  int errors = 0;
+  const std::vector<std::string> got = sentences(run(profile, in), &errors);
+  CHECK_EQ(got.size(), 6u);  // one epoch in ten
+  CHECK(got[0].compare(0, 6, "$GPRMC") == 0);
+}
+
+TEST(gps_only_1hz_input_is_untouched) {
+  OutputProfile profile;
+  std::string in;
+  for (int s = 0; s < 5; ++s) in += vx8test::gpsEpoch(9, 15, s);
+  CHECK(run(profile, in) == in);
+}
@@ -0,0 +1,40 @@
+#include "pmtk.h"
+
+#include <string>
+
+#include "test_support.h"
+#include "vx8_config.h"
+
+using namespace vx8;
+
+TEST(output_sentence_set) {
+  char buf[pmtk::kMaxSentence];
+  uint8_t n = pmtk::setOutput(VX8_SENTENCE_GGA | VX8_SENTENCE_RMC, buf);
+  CHECK_EQ(std::string(buf, n),
+           "$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*28\r\n");
+  n = pmtk::setOutput(VX8_PROFILE_SENTENCES, buf);
+  CHECK_EQ(std::string(buf, n),
+           "$PMTK314,0,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0*28\r\n");
+}
+
+TEST(rate_baud_and_test_sentences) {
+  char buf[pmtk::kMaxSentence];
+  uint8_t n = pmtk::setFixInterval(1000, buf);
+  CHECK_EQ(std::string(buf, n), "$PMTK220,1000*1F\r\n");
+  n = pmtk::setBaud(38400, buf);
+  CHECK_EQ(std::string(buf, n), "$PMTK251,38400*27\r\n");
+  n = pmtk::test(buf);
+  CHECK_EQ(std::string(buf, n), "$PMTK000*32\r\n");
+}
+
+TEST(parses_acknowledgements) {
+  NmeaParser p;
+  for (const char* c = "$PMTK001,314,3*36\r\n"; *c; ++c) {
+    p.feed(static_cast<uint8_t>(*c));
+  }
+  uint16_t cmd = 0;
+  uint8_t flag = 0;
+  CHECK(pmtk::parseAck(p, cmd, flag));
+  CHECK_EQ(cmd, 314);
+  CHECK_EQ(flag, pmtk::kAckOk);
+}
@@ -0,0 +1,229 @@
+#include "power_manager.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "filter_chain.h"
+#include "nmea_fixtures.h"
+#include "test_support.h"
+#include "ubx.h"
+
+using namespace vx8;
+
+namespace {
+
+// 9600 baud, 10 bits per byte.
+const uint64_t kByteUs = 1042;
+
+// A board running the sketch's main loop against a GPS that sends one burst
+// per second. Time is simulated in microseconds: the loop polls, asks the
+// power manager how to sleep and skips ahead to the next thing that would
+// wake it. While powered down the UART is off and arriving bytes are lost,
+// including the one that is halfway in when the MCU wakes.
+class Board {
+ public:
+  explicit Board(GpsModule module, const PowerConfig& config =
+                                       PowerConfig::defaults())
+      : power(module, config) {
+    chain.add(&PowerManager::filter, &power);
+    bridge.setFilter(&FilterChain::filter, &chain);
+  }
+
+  // Schedules `data` to start arriving at `atMs`.
+  void send(uint32_t atMs, const std::string& data) {
+    uint64_t t = uint64_t(atMs) * 1000;
+    for (char c : data) {
+      t += kByteUs;
+      rx_.push_back(Byte{t, static_cast<uint8_t>(c)});
+    }
+    sent += data;
+  }
+
+  void run(uint32_t untilMs) {
+    std::stable_sort(rx_.begin(), rx_.end(),
+                     [](const Byte& a, const Byte& b) { return a.us < b.us; });
+    const uint64_t end = uint64_t(untilMs) * 1000;
+    while (now_ < end) {
+      for (; next_ < rx_.size() && rx_[next_].us <= now_; ++next_) {
+        if (rx_[next_].us < awakeFrom_) {
+          ++lostBytes;
+        } else {
+          bridge.onRxByte(rx_[next_].b);
+        }
+      }
+      bridge.poll();
+      for (uint8_t b; txFreeUs_ <= now_ && bridge.nextTxByte(b);) {
+        txFreeUs_ = std::max(txFreeUs_, now_) + kByteUs;
+        radio.push_back(static_cast<char>(b));
+      }
+      const SleepRequest r =
+          power.update(static_cast<uint32_t>(now_ / 1000), bridge);
+      if (r.mode == SleepMode::PowerDown) {
+        now_ += uint64_t(r.ms) * 1000;
+        poweredDownUs += uint64_t(r.ms) * 1000;
+        awakeFrom_ = now_ + kByteUs;
+        continue;
+      }
+      // Idle: the next byte, transmitter slot or 1 ms timer tick.
+      uint64_t wake = (now_ / 1000 + 1) * 1000;
+      if (next_ < rx_.size()) wake = std::min(wake, rx_[next_].us);
+      if (bridge.txPending()) {
+        wake = std::min(wake, std::max(txFreeUs_, now_ + 1));
+      }
+      now_ = wake;
+    }
+  }
+
+  Bridge bridge;
+  FilterChain chain;
+  PowerManager power;
+  std::string sent;
+  std::string radio;
+  uint64_t poweredDownUs = 0;
+  uint32_t lostBytes = 0;
+
+ private:
+  struct Byte {
+    uint64_t us;
+    uint8_t b;
+  };
+  std::vector<Byte> rx_;
+  size_t next_ = 0;
+  uint64_t now_ = 0;
+  uint64_t awakeFrom_ = 0;
+  uint64_t txFreeUs_ = 0;
+};
+
+std::string epoch(int s) { return vx8test::gpsEpoch(8, s / 60, s % 60); }
+
+std::string noFixEpoch(int s) {
+  char t[16];
+  std::snprintf(t, sizeof(t), "0830%02d.00", s % 60);
+  return vx8test::nmea(std::string("GPGGA,") + t + ",,,,,0,00,99.99,,,,,,") +
+         vx8test::nmea(std::string("GPRMC,") + t + ",V,,,,,,,230394,,,N");
+}
+
+std::string rxm(bool powerSave) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  const uint8_t n = ubx::cfgRxm(powerSave, buf);
+  return std::string(reinterpret_cast<char*>(buf), n);
+}
+
+size_t count(const std::string& s, const std::string& what) {
+  size_t n = 0;
+  for (size_t i = s.find(what); i != std::string::npos;
+       i = s.find(what, i + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+}  // namespace
+
+TEST(powers_down_between_bursts_without_losing_output) {
+  Board board(GpsModule::Mediatek);
+  for (int s = 0; s < 60; ++s) board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  board.run(60000);
+  CHECK(board.radio == board.sent);
+  CHECK_EQ(board.lostBytes, 0u);
+  CHECK(board.power.locked());
+  CHECK_EQ(board.power.earlyBursts(), 0);
+  // A 5-sentence burst takes ~0.4 s of every second at 9600 baud.
+  CHECK(board.poweredDownUs > 60000000 * 4 / 10);
+}
+
+TEST(stays_awake_until_bursts_line_up) {
+  Board board(GpsModule::Mediatek);
+  for (int s = 0; s < 3; ++s) board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  board.run(3000);
+  CHECK(!board.power.locked());
+  CHECK_EQ(board.poweredDownUs, 0u);
+  CHECK(board.radio == board.sent);
+}
+
+TEST(early_burst_backs_off_and_relocks) {
+  Board board(GpsModule::Mediatek);
+  std::string late;
+  for (int s = 0; s < 40; ++s) {
+    // The module's output moves 300 ms earlier from the 20th second on.
+    const uint32_t at = uint32_t(s) * 1000 + (s < 20 ? 437 : 137);
+    board.send(at, epoch(s));
+    if (s >= 21) late += epoch(s);
+  }
+  board.run(40000);
+  CHECK(board.lostBytes > 0);
+  CHECK_EQ(board.power.earlyBursts(), 1);
+  CHECK_EQ(board.power.guardMs(), 2 * PowerConfig::defaults().guardMs);
+  CHECK(board.power.locked());
+  // Only the epoch that came early is affected.
+  CHECK(board.radio.size() >= board.sent.size() - epoch(20).size());
+  CHECK(board.radio.compare(board.radio.size() - late.size(), late.size(),
+                            late) == 0);
+}
+
+TEST(power_down_can_be_disabled) {
+  PowerConfig config = PowerConfig::defaults();
+  config.powerDown = false;
+  Board board(GpsModule::Mediatek, config);
+  for (int s = 0; s < 10; ++s) board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  board.run(10000);
+  CHECK(board.power.locked());
+  CHECK_EQ(board.poweredDownUs, 0u);
+  CHECK(board.radio == board.sent);
+}
+
+TEST(ublox_cyclic_tracking_follows_fix_quality) {
+  Board board(GpsModule::Ublox);
+  const int stable = PowerConfig::defaults().stableFixes;
+  int s = 0;
+  for (; s < stable + 2; ++s) board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  for (; s < stable + 4; ++s) {
+    board.send(uint32_t(s) * 1000 + 137, noFixEpoch(s));
+  }
+  board.run(uint32_t(s) * 1000);
+
+  const std::string save = rxm(true);
+  const std::string continuous = rxm(false);
+  CHECK_EQ(count(board.radio, save), 1u);
+  CHECK_EQ(count(board.radio, continuous), 1u);
+  CHECK(board.radio.find(save) < board.radio.find(continuous));
+  // CFG-PM2 goes out once, ahead of the first CFG-RXM.
+  const std::string pm2 = "\xB5\x62\x06\x3B";
+  CHECK_EQ(count(board.radio, pm2), 1u);
+  CHECK(board.radio.find(pm2) < board.radio.find(save));
+  CHECK(!board.power.moduleSaving());
+  // Injected between sentences, never inside one.
+  const size_t at = board.radio.find(pm2);
+  CHECK(at > 0 && board.radio[at - 1] == '\n');
+}
+
+TEST(mediatek_module_is_left_at_full_power) {
+  Board board(GpsModule::Mediatek);
+  for (int s = 0; s < 20; ++s) board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  board.run(20000);
+  CHECK(board.radio == board.sent);
+  CHECK(!board.power.moduleSaving());
+  CHECK_EQ(board.bridge.injectPending(), false);
+}
+
+TEST(module_commands_can_use_their_own_port) {
+  Board board(GpsModule::Ublox);
+  std::string sentToModule;
+  ConfigPort port;
+  port.write = [](void* ctx, const uint8_t* data, uint8_t len) {
+    static_cast<std::string*>(ctx)->append(reinterpret_cast<const char*>(data),
+                                           len);
+  };
+  port.setBaud = nullptr;
+  port.ctx = &sentToModule;
+  board.power.setModulePort(port);
+  const int stable = PowerConfig::defaults().stableFixes;
+  for (int s = 0; s < stable + 2; ++s) {
+    board.send(uint32_t(s) * 1000 + 137, epoch(s));
+  }
+  board.run(uint32_t(stable + 2) * 1000);
+  CHECK(board.power.moduleSaving());
+  CHECK(board.radio == board.sent);
+  CHECK_EQ(count(sentToModule, rxm(true)), 1u);
+}
@@ -0,0 +1,144 @@
+#include "pps_sync.h"
+
+#include <string>
+
+#include "nmea_fixtures.h"
+#include "stepped_rig.h"
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+// The stepped rig with PPS alignment as its only stage.
+class Rig : public vx8test::SteppedRig {
+ public:
+  explicit Rig(const PpsConfig& config = PpsConfig::defaults())
+      : pps(config) {
+    chain.add(&PpsSync::filter, &pps);
+    onEdge(&edge, &pps);
+    onUpdate(&update, &pps);
+  }
+
+  PpsSync pps;
+
+ private:
+  static void edge(void* ctx) { static_cast<PpsSync*>(ctx)->onPps(); }
+  static void update(void* ctx, uint32_t nowMs, Bridge& bridge) {
+    static_cast<PpsSync*>(ctx)->update(nowMs, bridge);
+  }
+};
+
+std::string epoch(int s) { return vx8test::gpsEpoch(8, 30, s); }
+
+std::string pair(int s) {
+  const std::string e = epoch(s);
+  const size_t gsa = e.find("$GPGSA");
+  return e.substr(0, gsa);
+}
+
+std::string rest(int s) {
+  const std::string e = epoch(s);
+  return e.substr(e.find("$GPGSA"));
+}
+
+}  // namespace
+
+TEST(forwards_as_usual_without_edges) {
+  Rig rig;
+  for (int s = 0; s < 4; ++s) rig.send(uint32_t(s) * 1000 + 200, epoch(s));
+  rig.run(5000);
+  CHECK(!rig.pps.synced());
+  CHECK_EQ(rig.pps.aligned(), 0);
+  CHECK(rig.radio() == epoch(0) + epoch(1) + epoch(2) + epoch(3));
+}
+
+TEST(releases_gga_and_rmc_on_the_next_edge) {
+  Rig rig;
+  rig.pulses(0, 10);
+  // The module finishes each epoch anywhere from 100 to 450 ms into the
+  // second; the early ones arrive while the last pair is still going out.
+  const uint32_t offsets[] = {300, 100, 450, 120, 380, 100, 250, 440, 100};
+  for (int s = 0; s < 9; ++s) {
+    rig.send(uint32_t(s) * 1000 + offsets[s], epoch(s));
+  }
+  rig.run(9600);
+
+  std::string expected;
+  for (int s = 0; s < 9; ++s) expected += rest(s) + pair(s);
+  CHECK(rig.radio() == expected);
+  for (int s = 0; s < 9; ++s) {
+    const uint32_t edge = uint32_t(s + 1) * 1000;
+    CHECK_EQ(rig.sentAt(pair(s).substr(0, 13), 0), edge);
+    // RMC follows without a gap.
+    CHECK_EQ(rig.sentAt(pair(s).substr(pair(s).find("$GPRMC"), 13), 0),
+             edge + uint32_t(pair(s).find("$GPRMC")));
+  }
+  CHECK_EQ(rig.pps.aligned(), 9);
+  CHECK_EQ(rig.pps.late(), 0);
+  CHECK(!rig.pps.holding());
+  // Held sentences bypass the TX queue.
+  CHECK_EQ(rig.bridge.stats().sentencesFiltered, 18);
+}
+
+TEST(sends_an_epoch_late_when_an_edge_is_missed) {
+  Rig rig;
+  rig.pulses(0, 3);
+  rig.pulses(4, 6);
+  for (int s = 0; s < 5; ++s) rig.send(uint32_t(s) * 1000 + 200, epoch(s));
+  rig.run(6000);
+
+  CHECK_EQ(rig.pps.late(), 1);
+  CHECK_EQ(rig.pps.aligned(), 4);
+  // Epoch 2 waits for the timeout instead of the edge that never came.
+  const uint32_t timeout = PpsConfig::defaults().timeoutMs;
+  // Held from the CR that completes its GGA.
+  const uint32_t held = 2200 + uint32_t(pair(2).find("$GPRMC")) - 2;
+  CHECK_EQ(rig.sentAt("$GPGGA,083002", 2000), held + timeout);
+  CHECK_EQ(rig.sentAt("$GPGGA,083003", 3000), 4000u);
+  CHECK_EQ(rig.sentAt("$GPGGA,083004", 4000), 5000u);
+}
+
+TEST(forwards_again_when_edges_stop) {
+  Rig rig;
+  rig.pulses(0, 2);
+  for (int s = 0; s < 6; ++s) rig.send(uint32_t(s) * 1000 + 200, epoch(s));
+  rig.run(6000);
+
+  CHECK(!rig.pps.synced());
+  CHECK(!rig.pps.holding());
+  // Nothing is lost on the way from aligned to plain forwarding.
+  std::string all;
+  for (int s = 0; s < 6; ++s) all += epoch(s);
+  CHECK_EQ(rig.radio().size(), all.size());
+  // Epochs 1 and 2 time out, epoch 3 goes when the edges count as lost.
+  CHECK_EQ(rig.pps.late(), 3);
+  CHECK(rig.sentAt("$GPGGA,083004", 4000) < rig.sentAt("$GPGSA", 4000));
+  CHECK(rig.sentAt("$GPGGA,083005", 5000) < rig.sentAt("$GPGSA", 5000));
+}
+
+TEST(keeps_the_board_awake_for_the_edge) {
+  Rig rig;
+  rig.pulses(0, 2);
+  rig.send(1200, epoch(1));
+  rig.run(1400);
+  CHECK(rig.pps.holding());
+
+  SleepRequest down;
+  down.mode = SleepMode::PowerDown;
+  down.ms = 700;
+  const uint16_t guard = PpsConfig::defaults().guardMs;
+  SleepRequest r = rig.pps.limit(down, 1400);
+  CHECK(r.mode == SleepMode::PowerDown);
+  CHECK_EQ(r.ms, 600 - guard);
+  r = rig.pps.limit(down, 1990);
+  CHECK(r.mode == SleepMode::Idle);
+  down.ms = 100;
+  r = rig.pps.limit(down, 1400);
+  CHECK_EQ(r.ms, 100);
+
+  rig.run(2400);
+  CHECK(!rig.pps.holding());
+  r = rig.pps.limit(down, 2400);
+  CHECK(r.mode == SleepMode::PowerDown);
+}
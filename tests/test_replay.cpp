@@ -0,0 +1,134 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <string>
+
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using namespace vx8::sim;
+
+namespace {
+
+std::string gpsCapture(int seconds) {
+  std::string capture;
+  for (int s = 0; s < seconds; ++s) capture += vx8test::gpsEpoch(8, 30, s);
+  return capture;
+}
+
+std::string gnssCapture(int seconds) {
+  std::string capture;
+  for (int s = 0; s < seconds; ++s) {
+    for (int cs = 0; cs < 100; cs += 20) {
+      capture += vx8test::gnssEpoch(8, 30, s, cs);
+    }
+  }
+  return capture;
+}
+
+ReplayReport replay(const std::string& capture, const ReplayConfig& config) {
+  return runReplay(reinterpret_cast<const uint8_t*>(capture.data()),
+                   capture.size(), config);
+}
+
+}  // namespace
+
+TEST(replay_is_deterministic) {
+  const std::string capture = gnssCapture(4);
+  ReplayConfig config;
+  config.line.loopPeriodUs = 2000;
+  const ReplayReport a = replay(capture, config);
+  const ReplayReport b = replay(capture, config);
+  CHECK(diffOutput(a.sim.radioOutput, b.sim.radioOutput).identical);
+  CHECK_EQ(a.sim.durationNs, b.sim.durationNs);
+  CHECK_EQ(a.sim.maxByteLatencyNs, b.sim.maxByteLatencyNs);
+  CHECK_EQ(a.sentences,
+           size_t(std::count(capture.begin(), capture.end(), '\n')));
+  CHECK_EQ(a.sim.stats.sentencesForwarded, 4 * 6);
+}
+
+TEST(latency_covers_waiting_for_the_whole_sentence) {
+  const std::string capture = gpsCapture(5);
+  ReplayConfig config;
+  config.profile = false;
+  config.motion = false;
+  const ReplayReport r = replay(capture, config);
+  CHECK(r.sim.radioOutput == capture);
+  // 9600 baud: 1.04 ms per byte. The '$' of a 70-byte GSV waits for the
+  // other 69 bytes, then for the sentence ahead of it on the radio line.
+  const uint64_t byteNs = 1041666;
+  CHECK(r.sim.maxByteLatencyNs > 69 * byteNs);
+  CHECK(r.sim.maxByteLatencyNs < 2 * 84 * byteNs);
+  CHECK(r.sim.maxParseLatencyNs <= 500000);
+  CHECK(r.sim.maxQueueLatencyNs < 84 * byteNs);
+  CHECK(r.sim.stats.txHighWater >= 1);
+}
+
+TEST(stalls_show_up_as_parse_latency) {
+  const std::string capture = gpsCapture(5);
+  ReplayConfig config;
+  config.line.stallEveryUs = 700000;
+  config.line.stallUs = 30000;
+  const ReplayReport r = replay(capture, config);
+  CHECK_EQ(r.sim.stats.rxOverruns, 0);
+  // Less the byte time between the last poll and the next byte.
+  CHECK(r.sim.maxParseLatencyNs >= 29000000);
+  CHECK(r.sim.stats.rxHighWater > 28);
+}
+
+TEST(benchmark_counts_every_pass) {
+  const std::string capture = gnssCapture(2);
+  ReplayConfig config;
+  config.benchmarkPasses = 3;
+  const ReplayReport r = replay(capture, config);
+  CHECK_EQ(r.benchmarkBytes, 3u * capture.size());
+  CHECK(r.benchmarkSeconds > 0);
+  CHECK(r.sentencesPerSecond() > 0);
+}
+
+TEST(diff_pinpoints_a_behaviour_change) {
+  const std::string capture = gnssCapture(6);
+  ReplayConfig config;
+  config.motion = false;
+  const std::string before = replay(capture, config).sim.radioOutput;
+  config.motion = true;  // zeroes the RMC speed once the position is held
+  const std::string after = replay(capture, config).sim.radioOutput;
+  const OutputDiff d = diffOutput(before, after);
+  CHECK(!d.identical);
+  CHECK_EQ(d.sentence, 2u * 6u);  // RMC of the third second
+  CHECK(d.expected.compare(0, 6, "$GPRMC") == 0);
+  CHECK(d.expected.find(",0.012,") != std::string::npos);
+  CHECK(d.actual.find(",0.000,") != std::string::npos);
+}
+
+TEST(diff_reports_truncated_output) {
+  const OutputDiff d = diffOutput("$A*00\r\n$B*00\r\n", "$A*00\r\n");
+  CHECK(!d.identical);
+  CHECK_EQ(d.offset, 7u);
+  CHECK_EQ(d.sentence, 1u);
+  CHECK_EQ(d.expected, "$B*00");
+  CHECK_EQ(d.actual, "");
+  CHECK(diffOutput("", "").identical);
+}
+
+TEST(reports_device_counters) {
+  std::string capture = gpsCapture(3) + vx8test::nmea("PVX8Q");
+  std::string bad = vx8test::gpsEpoch(8, 30, 3);
+  bad[10] = '9';  // breaks the GGA checksum
+  capture += bad;
+  ReplayConfig config;
+  config.line.stallEveryUs = 700000;
+  config.line.stallUs = 30000;
+  const ReplayReport r = replay(capture, config);
+  const vx8::Counters& c = r.counters;
+  CHECK_EQ(c.bytesIn, capture.size());
+  CHECK_EQ(c.bytesOut, r.sim.radioOutput.size());
+  CHECK_EQ(c.checksumErrors, 1);
+  CHECK_EQ(c.sentencesFiltered, 1);  // the query
+  CHECK_EQ(c.maxLoopUs, 30000u);
+  CHECK_EQ(c.fixAgeS, 0);
+  // Answered on the radio side, between the sentences.
+  const size_t at = r.sim.radioOutput.find("$PVX8S,1,");
+  CHECK(at != std::string::npos && r.sim.radioOutput[at - 1] == '\n');
+  CHECK(r.sim.radioOutput.find("\r\n$PVX8S,2,") != std::string::npos);
+}
@@ -0,0 +1,59 @@
+#include "ring_buffer.h"
+
+#include "test_support.h"
+
+using vx8::SpscRing;
+
+TEST(push_pop_fifo) {
+  SpscRing<uint8_t, 8> r;
+  CHECK(r.empty());
+  for (uint8_t i = 0; i < 7; ++i) CHECK(r.push(i));
+  CHECK(!r.push(99));  // one slot stays free
+  CHECK_EQ(r.size(), 7);
+  uint8_t v;
+  for (uint8_t i = 0; i < 7; ++i) {
+    CHECK(r.pop(v));
+    CHECK_EQ(v, i);
+  }
+  CHECK(!r.pop(v));
+}
+
+TEST(wraps_around) {
+  SpscRing<uint16_t, 4> r;
+  uint16_t v;
+  for (uint16_t i = 0; i < 100; ++i) {
+    CHECK(r.push(i));
+    CHECK(r.push(static_cast<uint16_t>(i + 1000)));
+    CHECK(r.pop(v) && v == i);
+    CHECK(r.pop(v) && v == i + 1000);
+  }
+  CHECK(r.empty());
+}
+
+TEST(peek_and_drop) {
+  SpscRing<int, 4> r;
+  int v = 0;
+  CHECK(!r.peek(v));
+  r.push(5);
+  CHECK(r.peek(v) && v == 5);
+  CHECK_EQ(r.size(), 1);
+  r.drop();
+  CHECK(r.empty());
+}
+
+TEST(in_place_access_and_bulk_release) {
+  SpscRing<uint8_t, 16> r;
+  for (uint8_t i = 0; i < 10; ++i) r.push(i);
+  const auto t = r.tailIndex();
+  CHECK_EQ(r.at(t + 3), 3);
+  r.at(t + 3) = 42;
+  r.releaseTo(SpscRing<uint8_t, 16>::wrap(t + 3));
+  CHECK_EQ(r.size(), 7);
+  uint8_t v;
+  CHECK(r.pop(v) && v == 42);
+}
+
+TEST(single_byte_indices_up_to_256) {
+  CHECK_EQ(sizeof(SpscRing<uint8_t, 256>::Index), 1u);
+  CHECK_EQ(sizeof(SpscRing<uint8_t, 512>::Index), 2u);
+}
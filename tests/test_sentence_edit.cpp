@@ -0,0 +1,75 @@
+#include "sentence_edit.h"
+
+#include <cstring>
+#include <string>
+
+#include "nmea_fixtures.h"
+#include "test_support.h"
+
+using vx8::NmeaParser;
+using vx8::SentenceView;
+
+namespace {
+
+bool parse(NmeaParser& p, const std::string& s) {
+  bool got = false;
+  for (char c : s) {
+    if (p.feed(static_cast<uint8_t>(c)) == NmeaParser::Status::Sentence) {
+      got = true;
+    }
+  }
+  return got;
+}
+
+}  // namespace
+
+TEST(rewrites_and_reparses) {
+  const std::string s = vx8test::nmea("GNGSV,4,1,14,01,40,083,46");
+  NmeaParser p;
+  CHECK(parse(p, s));
+  uint8_t buf[128];
+  std::memcpy(buf, s.data(), s.size());
+  SentenceView v(buf, 0xFF, 0, p.length(), p.checksumOffset());
+  v.setTalker('G', 'P');
+  CHECK(v.writeUnsigned(p.fieldOffset(3), p.field(3).len, 9));
+  v.updateChecksum();
+  const std::string edited(reinterpret_cast<char*>(buf), v.length());
+  CHECK(edited + "\r\n" == vx8test::nmea("GPGSV,4,1,09,01,40,083,46"));
+}
+
+TEST(refuses_values_wider_than_the_field) {
+  char buf[] = "$GPGSV,4,1,14*00";
+  SentenceView v(reinterpret_cast<uint8_t*>(buf), 0xFF, 0, 16, 13);
+  CHECK(!v.writeUnsigned(7, 1, 12));
+  CHECK_EQ(buf[7], '4');
+  CHECK(v.writeUnsigned(11, 2, 0));
+  CHECK_EQ(std::string(buf, 13), "$GPGSV,4,1,00");
+}
+
+TEST(truncates_trailing_fields) {
+  const std::string s = vx8test::nmea("GNGSA,A,3,04,,,,,,,,,,,,1.32,0.71,1.11,1");
+  NmeaParser p;
+  CHECK(parse(p, s));
+  uint8_t buf[128];
+  std::memcpy(buf, s.data(), s.size());
+  SentenceView v(buf, 0xFF, 0, p.length(), p.checksumOffset());
+  CHECK(!v.truncateAt(p.fieldOffset(18)));  // not a comma
+  CHECK(v.truncateAt(p.fieldOffset(18) - 1));
+  v.updateChecksum();
+  const std::string edited(reinterpret_cast<char*>(buf), v.length());
+  CHECK(edited + "\r\n" ==
+        vx8test::nmea("GNGSA,A,3,04,,,,,,,,,,,,1.32,0.71,1.11"));
+}
+
+TEST(wraps_around_the_buffer) {
+  // Sentence stored starting 4 bytes before the end of a 16-byte ring.
+  const char* s = "$GNXYZ,1*00";
+  uint8_t ring[16] = {};
+  for (uint8_t i = 0; s[i]; ++i) ring[(12 + i) & 15] = static_cast<uint8_t>(s[i]);
+  SentenceView v(ring, 15, 12, 11, 8);
+  v.setTalker('G', 'P');
+  v.updateChecksum();
+  CHECK_EQ(ring[13], 'G');
+  CHECK_EQ(ring[14], 'P');
+  CHECK_EQ(v.get(9), ring[(12 + 9) & 15]);
+}
@@ -0,0 +1,43 @@
+// Minimal self-registering test harness for the host build.
+//
+// Each test binary is one module's test file linked with test_main.cpp. A
+// failed CHECK reports and keeps going so one run shows every failure.
+
+#ifndef VX8_TEST_SUPPORT_H
+#define VX8_TEST_SUPPORT_H
+
+#include <cstdio>
+
+namespace vx8test {
+
+using TestFn = void (*)();
+
+struct TestCase {
+  const char* name;
+  TestFn fn;
+  TestCase* next;
+};
+
+void registerTest(TestCase* tc);
+void recordFailure(const char* file, int line, const char* expr);
+
+struct Registrar {
+  explicit Registrar(TestCase* tc) { registerTest(tc); }
+};
+
+}  // namespace vx8test
+
+#define TEST(name)                                                   \
+  static void name();                                                \
+  static vx8test::TestCase name##_case = {#name, &name, nullptr};    \
+  static vx8test::Registrar name##_registrar(&name##_case);          \
+  static void name()
+
+#define CHECK(expr)                                           \
+  do {                                                        \
+    if (!(expr)) vx8test::recordFailure(__FILE__, __LINE__, #expr); \
+  } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+#endif  // VX8_TEST_SUPPORT_H
@@ -0,0 +1,112 @@
+#include "ubx.h"
+
+#include <vector>
+
+#include "test_support.h"
+
+using namespace vx8;
+
+namespace {
+
+std::vector<uint8_t> bytes(const uint8_t* p, uint8_t n) {
+  return std::vector<uint8_t>(p, p + n);
+}
+
+}  // namespace
+
+TEST(cfg_rate_frame) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  const uint8_t n = ubx::cfgRate(1000, buf);
+  const std::vector<uint8_t> want = {0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xE8,
+                                     0x03, 0x01, 0x00, 0x01, 0x00, 0x01, 0x39};
+  CHECK(bytes(buf, n) == want);
+}
+
+TEST(cfg_msg_frame) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  const uint8_t n = ubx::cfgMsg(ubx::kClassNmea, ubx::kNmeaGll, 0, buf);
+  const std::vector<uint8_t> want = {0xB5, 0x62, 0x06, 0x01, 0x03, 0x00,
+                                     0xF0, 0x01, 0x00, 0xFB, 0x11};
+  CHECK(bytes(buf, n) == want);
+}
+
+TEST(cfg_prt_frame) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  const uint8_t n = ubx::cfgPrt(9600, buf);
+  const std::vector<uint8_t> want = {
+      0xB5, 0x62, 0x06, 0x00, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00,
+      0xD0, 0x08, 0x00, 0x00, 0x80, 0x25, 0x00, 0x00, 0x03, 0x00,
+      0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9E, 0x95};
+  CHECK(bytes(buf, n) == want);
+  CHECK_EQ(n, 28);
+}
+
+TEST(cfg_rxm_frames) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  uint8_t n = ubx::cfgRxm(true, buf);
+  CHECK(bytes(buf, n) == std::vector<uint8_t>({0xB5, 0x62, 0x06, 0x11, 0x02,
+                                               0x00, 0x08, 0x01, 0x22, 0x92}));
+  n = ubx::cfgRxm(false, buf);
+  CHECK(bytes(buf, n) == std::vector<uint8_t>({0xB5, 0x62, 0x06, 0x11, 0x02,
+                                               0x00, 0x08, 0x00, 0x21, 0x91}));
+}
+
+TEST(cfg_pm2_frame_decodes) {
+  uint8_t buf[ubx::kMaxEncodedFrame];
+  const uint8_t n = ubx::cfgPm2(1000, buf);
+  CHECK_EQ(n, ubx::kMaxEncodedFrame);
+  ubx::Parser p;
+  int frames = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (p.feed(buf[i]) == ubx::Parser::Status::Frame) ++frames;
+  }
+  CHECK_EQ(frames, 1);
+  CHECK_EQ(p.msgId(), ubx::kIdCfgPm2);
+  CHECK_EQ(p.length(), 44);
+  CHECK_EQ(p.payload()[8], 0xE8);  // updatePeriod 1000 ms
+  CHECK_EQ(p.payload()[9], 0x03);
+  CHECK_EQ(p.payload()[6], 0x02);  // cyclic tracking
+}
+
+TEST(decodes_ack_amid_nmea_noise) {
+  const std::vector<uint8_t> stream = {
+      '$', 'G', 'P', 0xB5, 0xB5, 0x62, 0x05, 0x01, 0x02,
+      0x00, 0x06, 0x01, 0x0F, 0x38, '\r', '\n'};
+  ubx::Parser p;
+  int frames = 0;
+  for (uint8_t b : stream) {
+    if (p.feed(b) == ubx::Parser::Status::Frame) ++frames;
+  }
+  CHECK_EQ(frames, 1);
+  bool positive = false;
+  uint8_t cls = 0, id = 0;
+  CHECK(p.isAck(positive, cls, id));
+  CHECK(positive);
+  CHECK_EQ(cls, ubx::kClassCfg);
+  CHECK_EQ(id, ubx::kIdCfgMsg);
+}
+
+TEST(rejects_corrupt_frame) {
+  const std::vector<uint8_t> stream = {0xB5, 0x62, 0x05, 0x00, 0x02,
+                                       0x00, 0x06, 0x01, 0x0F, 0x38};
+  ubx::Parser p;
+  bool error = false;
+  for (uint8_t b : stream) {
+    if (p.feed(b) == ubx::Parser::Status::Error) error = true;
+  }
+  CHECK(error);
+}
+
+TEST(round_trips_long_frames) {
+  // Payloads longer than the kept prefix still checksum correctly.
+  uint8_t payload[40];
+  for (uint8_t i = 0; i < sizeof(payload); ++i) payload[i] = i;
+  uint8_t buf[64];
+  const uint8_t n = ubx::encode(0x0A, 0x04, payload, sizeof(payload), buf);
+  ubx::Parser p;
+  ubx::Parser::Status st = ubx::Parser::Status::Busy;
+  for (uint8_t i = 0; i < n; ++i) st = p.feed(buf[i]);
+  CHECK(st == ubx::Parser::Status::Frame);
+  CHECK_EQ(p.length(), 40);
+  CHECK_EQ(p.payload()[31], 31);
+}
@@ -0,0 +1,155 @@
+#include "line_sim.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace vx8 {
+namespace sim {
+
+namespace {
+
+// 8N1: ten bit times per byte.
+uint64_t byteTimeNs(uint32_t baud) { return 10ULL * 1000000000ULL / baud; }
+
+const uint64_t kNever = ~0ULL;
+
+// A forwarded sentence on its way to the radio.
+struct Pending {
+  uint16_t start;   // receive buffer index of its '$'
+  uint8_t length;   // bytes received, '$' through the checksum
+  uint64_t queuedNs;
+};
+
+// Wraps the bridge's own filter and notes every sentence it lets through.
+struct Tap {
+  Bridge::SentenceFilter inner;
+  void* innerCtx;
+  std::vector<Pending> accepted;
+
+  static bool filter(void* ctx, const NmeaParser& p, SentenceView& raw) {
+    Tap* t = static_cast<Tap*>(ctx);
+    if (t->inner && !t->inner(t->innerCtx, p, raw)) return false;
+    t->accepted.push_back({raw.start(), p.length(), 0});
+    return true;
+  }
+};
+
+}  // namespace
+
+LineSimResult runLineSim(Bridge& bridge, const uint8_t* data, size_t size,
+                         const LineSimConfig& config) {
+  LineSimResult result;
+  const uint64_t rxByteNs = byteTimeNs(config.rxBaud);
+  const uint64_t txByteNs = byteTimeNs(config.txBaud);
+  const uint64_t loopNs = uint64_t(config.loopPeriodUs) * 1000;
+  const uint64_t stallEveryNs = uint64_t(config.stallEveryUs) * 1000;
+
+  size_t rxPos = 0;
+  uint64_t nextRx = size ? rxByteNs : kNever;
+  uint64_t nextLoop = loopNs;
+  uint64_t nextStall = stallEveryNs ? stallEveryNs : kNever;
+  uint64_t txFree = 0;  // when the transmitter finishes its current byte
+  bool txArmed = false;
+  bool polledSinceRx = true;
+  uint64_t now = 0;
+
+  // Arrival time of the byte in each receive buffer slot. Slots are filled
+  // in order, so the next one is the count of accepted bytes.
+  std::vector<uint64_t> arrivalNs(Bridge::RxRing::kMask + 1);
+  uint32_t pushed = 0;
+  uint64_t oldestUnparsed = kNever;
+  Tap tap = {bridge.filter(), bridge.filterContext(), {}};
+  bridge.setFilter(&Tap::filter, &tap);
+  std::deque<Pending> inFlight;
+  uint16_t txPos = 0;
+
+  for (;;) {
+    // The transmitter pulls a byte as soon as it is free and armed, like the
+    // data-register-empty interrupt does.
+    const uint64_t nextTx = txArmed ? std::max(txFree, now) : kNever;
+    const bool inputDone = rxPos == size;
+    if (inputDone && polledSinceRx && !txArmed && !bridge.txPending()) {
+      break;
+    }
+    now = std::min(nextRx, std::min(nextLoop, nextTx));
+    if (now == kNever) break;
+
+    if (now == nextRx) {
+      const uint16_t overruns = bridge.stats().rxOverruns;
+      bridge.onRxByte(data[rxPos++]);
+      if (bridge.stats().rxOverruns == overruns) {
+        arrivalNs[pushed++ & Bridge::RxRing::kMask] = now;
+        if (oldestUnparsed == kNever) oldestUnparsed = now;
+      }
+      polledSinceRx = false;
+      nextRx = rxPos < size ? now + rxByteNs : kNever;
+    }
+    if (now == nextTx) {
+      // Injections only go out between sentences.
+      const bool injected = txPos == 0 && bridge.injectPending();
+      uint8_t b;
+      if (bridge.nextTxByte(b)) {
+        result.radioOutput.push_back(static_cast<char>(b));
+        txFree = now + txByteNs;
+        if (!injected && !inFlight.empty()) {
+          const Pending& p = inFlight.front();
+          if (txPos == 0) {
+            result.maxQueueLatencyNs =
+                std::max(result.maxQueueLatencyNs, now - p.queuedNs);
+          }
+          const uint16_t k = std::min<uint16_t>(txPos, p.length - 1);
+          const uint64_t arrived =
+              arrivalNs[(p.start + k) & Bridge::RxRing::kMask];
+          result.maxByteLatencyNs =
+              std::max(result.maxByteLatencyNs, txFree - arrived);
+          if (b == '\n') {
+            inFlight.pop_front();
+            txPos = 0;
+          } else {
+            ++txPos;
+          }
+        }
+      } else {
+        txArmed = false;
+      }
+    }
+    if (now == nextLoop) {
+      if (oldestUnparsed != kNever) {
+        result.maxParseLatencyNs =
+            std::max(result.maxParseLatencyNs, now - oldestUnparsed);
+        oldestUnparsed = kNever;
+      }
+      const uint16_t queueFull = bridge.stats().txQueueFull;
+      tap.accepted.clear();
+      if (bridge.poll()) txArmed = true;
+      // Nothing is sent during a poll, so once the queue is full the rest of
+      // the poll's sentences are the ones dropped.
+      const size_t dropped =
+          static_cast<uint16_t>(bridge.stats().txQueueFull - queueFull);
+      for (size_t i = 0; i + dropped < tap.accepted.size(); ++i) {
+        tap.accepted[i].queuedNs = now;
+        inFlight.push_back(tap.accepted[i]);
+      }
+      polledSinceRx = true;
+      uint64_t busyNs = 0;
+      if (now >= nextStall) {
+        busyNs = uint64_t(config.stallUs) * 1000;
+        nextStall += stallEveryNs;
+      }
+      if (config.onLoop) {
+        config.onLoop(config.loopCtx, bridge, now, busyNs);
+        if (bridge.txPending()) txArmed = true;
+      }
+      nextLoop = now + loopNs + busyNs;
+    }
+  }
+
+  bridge.setFilter(tap.inner, tap.innerCtx);
+  result.durationNs = std::max(now, txFree);
+  result.stats = bridge.stats();
+  return result;
+}
+
+}  // namespace sim
+}  // namespace vx8
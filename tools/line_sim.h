@@ -0,0 +1,63 @@
+// Host-side line-rate simulation of the bridge.
+//
+// Replays a recorded GPS byte stream into a Bridge exactly as the UARTs would
+// on hardware: one RX interrupt per byte time at the GPS baud rate, one TX
+// interrupt per byte time at the radio baud rate while output is pending, and
+// the main loop polling at a configurable period with optional periodic
+// stalls standing in for other work. The capture is replayed back to back
+// with no idle time between bursts, which is the worst case for the buffers.
+// Everything runs on a simulated nanosecond clock, so results are
+// deterministic.
+//
+// Latency is measured per forwarded byte, from the end of its byte time on
+// the GPS line to the end of its byte time on the radio line (CR LF count as
+// the sentence's last byte). The simulation taps the bridge's filter to learn
+// where each forwarded sentence starts in the receive buffer, and restores
+// it before returning. Bytes the main loop injects (Bridge::inject) go out
+// between sentences and are not part of the latency figures.
+
+#ifndef VX8_TOOLS_LINE_SIM_H
+#define VX8_TOOLS_LINE_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "bridge.h"
+
+namespace vx8 {
+namespace sim {
+
+struct LineSimConfig {
+  uint32_t rxBaud = 9600;
+  uint32_t txBaud = 9600;
+  uint32_t loopPeriodUs = 500;  // main loop poll interval
+  uint32_t stallEveryUs = 0;    // 0 disables stalls
+  uint32_t stallUs = 0;         // extra main-loop delay per stall
+
+  // Called on every main-loop pass right after Bridge::poll(), with the
+  // pass's start time and how long it takes (the stall, if any). It may
+  // inject into the bridge.
+  void (*onLoop)(void* ctx, Bridge& bridge, uint64_t nowNs,
+                 uint64_t busyNs) = nullptr;
+  void* loopCtx = nullptr;
+};
+
+struct LineSimResult {
+  BridgeStats stats;
+  uint64_t durationNs = 0;
+  std::string radioOutput;  // every byte handed to the radio UART
+
+  // Worst cases over the run, in nanoseconds.
+  uint64_t maxByteLatencyNs = 0;   // GPS line to radio line, any byte
+  uint64_t maxParseLatencyNs = 0;  // received until the main loop parsed it
+  uint64_t maxQueueLatencyNs = 0;  // queued until its first byte went out
+};
+
+LineSimResult runLineSim(Bridge& bridge, const uint8_t* data, size_t size,
+                         const LineSimConfig& config);
+
+}  // namespace sim
+}  // namespace vx8
+
+#endif  // VX8_TOOLS_LINE_SIM_H
@@ -0,0 +1,108 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "pipeline.h"
+
+namespace vx8 {
+namespace sim {
+
+namespace {
+
+// Bytes fed between polls in the benchmark; well inside the receive buffer
+// so nothing is lost however the output queue drains.
+const size_t kBenchmarkChunk = 64;
+
+PipelineStages stagesFor(const ReplayConfig& config) {
+  PipelineStages s = PipelineStages::defaults();
+  s.profile = config.profile;
+  s.motion = s.motion && config.motion;
+  return s;
+}
+
+// Firmware::loop() around Bridge::poll(), on the simulated clock. There is
+// no board, so the sleep it asks for is not taken.
+void onLoop(void* ctx, Bridge&, uint64_t nowNs, uint64_t busyNs) {
+  Pipeline& p = *static_cast<Pipeline*>(ctx);
+  p.monitor().beginLoop(uint32_t(nowNs / 1000));
+  p.update(uint32_t(nowNs / 1000000));
+  p.monitor().endLoop(uint32_t((nowNs + busyNs) / 1000));
+}
+
+std::string lineAt(const std::string& s, size_t offset) {
+  size_t begin = s.rfind('\n', offset ? offset - 1 : 0);
+  begin = begin == std::string::npos || begin >= offset ? 0 : begin + 1;
+  size_t end = s.find_first_of("\r\n", offset);
+  if (end == std::string::npos) end = s.size();
+  return s.substr(begin, end - begin);
+}
+
+}  // namespace
+
+double ReplayReport::sentencesPerSecond() const {
+  if (benchmarkSeconds <= 0) return 0;
+  return double(sentences) * benchmarkPasses / benchmarkSeconds;
+}
+
+double ReplayReport::bytesPerSecond() const {
+  if (benchmarkSeconds <= 0) return 0;
+  return double(benchmarkBytes) / benchmarkSeconds;
+}
+
+ReplayReport runReplay(const uint8_t* data, size_t size,
+                       const ReplayConfig& config) {
+  ReplayReport report;
+  {
+    Pipeline p;
+    p.begin(stagesFor(config));
+    LineSimConfig line = config.line;
+    line.onLoop = &onLoop;
+    line.loopCtx = &p;
+    report.sim = runLineSim(p.bridge(), data, size, line);
+    report.counters = p.monitor().snapshot(
+        uint32_t(report.sim.durationNs / 1000000), p.bridge());
+  }
+  const BridgeStats& s = report.sim.stats;
+  report.sentences = uint32_t(s.sentencesForwarded) + s.sentencesFiltered +
+                     s.txQueueFull;
+
+  report.benchmarkPasses = config.benchmarkPasses;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t pass = 0; pass < config.benchmarkPasses; ++pass) {
+    Pipeline p;
+    p.begin(stagesFor(config));
+    for (size_t i = 0; i < size; i += kBenchmarkChunk) {
+      const size_t end = std::min(size, i + kBenchmarkChunk);
+      for (size_t j = i; j < end; ++j) p.bridge().onRxByte(data[j]);
+      p.bridge().poll();
+      uint8_t b;
+      while (p.bridge().nextTxByte(b)) {
+      }
+    }
+    report.benchmarkBytes += size;
+  }
+  report.benchmarkSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return report;
+}
+
+OutputDiff diffOutput(const std::string& expected, const std::string& actual) {
+  OutputDiff d;
+  const size_t n = std::min(expected.size(), actual.size());
+  size_t i = 0;
+  while (i < n && expected[i] == actual[i]) ++i;
+  if (i == n && expected.size() == actual.size()) return d;
+
+  d.identical = false;
+  d.offset = i;
+  d.sentence = size_t(std::count(expected.begin(), expected.begin() + long(i),
+                                 '\n'));
+  d.expected = lineAt(expected, i);
+  d.actual = lineAt(actual, i);
+  return d;
+}
+
+}  // namespace sim
+}  // namespace vx8
@@ -0,0 +1,65 @@
+// Host-side replay of recorded GPS captures through the whole firmware
+// pipeline (pipeline.h): the parser and every filter stage the firmware
+// runs, in its order, then the radio output. Only the board is missing.
+//
+// A replay runs the capture once through the line-rate simulation (see
+// line_sim.h) for deterministic buffer and latency figures, the device's
+// diagnostic counters (monitor.h) and the exact radio-side byte stream.
+// Then it optionally pushes the capture through a fresh pipeline as fast as
+// the host allows to measure parsing throughput. The byte stream can be
+// compared against one saved from another firmware version with
+// diffOutput().
+
+#ifndef VX8_TOOLS_REPLAY_H
+#define VX8_TOOLS_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "line_sim.h"
+#include "monitor.h"
+
+namespace vx8 {
+namespace sim {
+
+struct ReplayConfig {
+  LineSimConfig line;  // onLoop is taken by the replay
+  bool profile = true;  // run the output profile
+  bool motion = true;   // run the motion filter, if VX8_MOTION_FILTER
+  uint32_t benchmarkPasses = 0;  // wall-clock passes; 0 skips the benchmark
+};
+
+struct ReplayReport {
+  LineSimResult sim;
+  // Checksum-valid sentences seen per pass.
+  uint32_t sentences = 0;
+  // What a $PVX8Q query would report at the end of the run.
+  Counters counters = {};
+
+  // Benchmark: total wall-clock time for all passes.
+  uint32_t benchmarkPasses = 0;
+  double benchmarkSeconds = 0;
+  uint64_t benchmarkBytes = 0;
+
+  double sentencesPerSecond() const;
+  double bytesPerSecond() const;
+};
+
+ReplayReport runReplay(const uint8_t* data, size_t size,
+                       const ReplayConfig& config);
+
+struct OutputDiff {
+  bool identical = true;
+  size_t offset = 0;    // first differing byte
+  size_t sentence = 0;  // zero-based line number containing it
+  std::string expected;  // that line in each stream, without CR LF
+  std::string actual;
+};
+
+OutputDiff diffOutput(const std::string& expected, const std::string& actual);
+
+}  // namespace sim
+}  // namespace vx8
+
+#endif  // VX8_TOOLS_REPLAY_H
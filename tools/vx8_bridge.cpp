@@ -0,0 +1,117 @@
+// Runs the firmware on Linux (board_linux.h): the same setup() and loop() as
+// the example sketch, with the GPS and the radio on file descriptors.
+//
+//   vx8_bridge [options]
+//     --gps PATH    GPS side: a serial device, pty or FIFO (default stdin)
+//     --radio PATH  radio side (default stdout)
+//     --pty         create a pseudo-terminal for each side that has no PATH
+//                   and print its name, e.g. for gpsfake or a terminal
+//     --configure   run the module configurator first (needs a writable GPS
+//                   side)
+//     --log FILE    keep the track log (fix_logger.h) in FILE, 1 MiB or the
+//                   file's size if larger; read it with vx8_logdump
+//
+// Stops when the GPS side reaches end of file and the output has drained.
+// SIGUSR1 is a PPS edge (pps_sync.h), e.g. from a script watching
+// /dev/pps0; without it fixes are forwarded as they arrive.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include "board.h"
+#include "board_linux.h"
+#include "firmware.h"
+
+namespace {
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: vx8_bridge [--gps PATH] [--radio PATH] [--pty] "
+               "[--configure] [--log FILE]\n");
+  return 2;
+}
+
+// Opens `path`, or a new pty if `pty` is set and there is no path, or falls
+// back to `fallback`.
+int openSide(const char* path, bool pty, int flags, int fallback,
+             const char* side) {
+  if (path) {
+    const int fd = open(path, flags | O_NOCTTY);
+    if (fd < 0) std::fprintf(stderr, "vx8_bridge: cannot open %s\n", path);
+    return fd;
+  }
+  if (!pty) return fallback;
+  char name[64];
+  const int fd = vx8::board::openPty(name, sizeof(name));
+  if (fd < 0) {
+    std::fprintf(stderr, "vx8_bridge: cannot create a pty\n");
+  } else {
+    std::fprintf(stderr, "%s side: %s\n", side, name);
+  }
+  return fd;
+}
+
+// The log file, at least 1 MiB and a whole number of 4 KiB sectors.
+uint32_t logPages(int fd) {
+  const off_t size = lseek(fd, 0, SEEK_END);
+  const uint32_t kMinPages = 4096;
+  const uint32_t pages = size > 0 ? uint32_t(size / 4096) * 16 : 0;
+  return pages > kMinPages ? pages : kMinPages;
+}
+
+void onPps(int) { vx8::board::pulsePps(); }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* gpsPath = nullptr;
+  const char* radioPath = nullptr;
+  bool pty = false;
+  bool configure = false;
+  const char* logPath = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--gps") == 0 && hasValue) {
+      gpsPath = argv[++i];
+    } else if (std::strcmp(arg, "--radio") == 0 && hasValue) {
+      radioPath = argv[++i];
+    } else if (std::strcmp(arg, "--pty") == 0) {
+      pty = true;
+    } else if (std::strcmp(arg, "--configure") == 0) {
+      configure = true;
+    } else if (std::strcmp(arg, "--log") == 0 && hasValue) {
+      logPath = argv[++i];
+    } else {
+      return usage();
+    }
+  }
+
+  const int gpsFd = openSide(gpsPath, pty, O_RDWR, STDIN_FILENO, "GPS");
+  const int radioFd = openSide(radioPath, pty, O_WRONLY, STDOUT_FILENO,
+                               "radio");
+  if (gpsFd < 0 || radioFd < 0) return 1;
+
+  vx8::board::useFds(gpsFd, radioFd);
+  if (logPath) {
+    const int logFd = open(logPath, O_RDWR | O_CREAT, 0644);
+    if (logFd < 0) {
+      std::fprintf(stderr, "vx8_bridge: cannot open %s\n", logPath);
+      return 1;
+    }
+    vx8::board::useLogFile(logFd, logPages(logFd));
+  }
+  static vx8::Firmware firmware;
+  firmware.setup(configure);
+  std::signal(SIGUSR1, onPps);
+  while (!vx8::board::inputClosed() || !firmware.drained()) {
+    firmware.loop();
+  }
+  firmware.logger().flush();
+  while (!firmware.logger().log().flushed()) firmware.loop();
+  return 0;
+}
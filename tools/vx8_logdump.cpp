@@ -0,0 +1,90 @@
+// Prints a track log (fix_log.h) as NMEA or GPX, the same lines the device
+// streams in answer to $PVX8L: from a file kept by vx8_bridge --log, a dump
+// of the SPI flash chip, or VX8LOG.BIN off the SD card.
+//
+//   vx8_logdump [options] IMAGE
+//     --gpx         a GPX 1.1 track
+//     --nmea        $GPRMC and $GPGGA per record (default)
+//     --sector N    erase block size in pages: 16 for flash (default), 1
+//                   for an SD card image
+//
+// Exit status: 0 ok, 1 I/O error or no log in IMAGE, 2 usage.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "fix_log.h"
+#include "log_export.h"
+#include "log_media.h"
+
+namespace {
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: vx8_logdump [--gpx | --nmea] [--sector N] IMAGE\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  vx8::LogFormat format = vx8::LogFormat::Nmea;
+  long sector = 16;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--gpx") == 0) {
+      format = vx8::LogFormat::Gpx;
+    } else if (std::strcmp(arg, "--nmea") == 0) {
+      format = vx8::LogFormat::Nmea;
+    } else if (std::strcmp(arg, "--sector") == 0 && i + 1 < argc) {
+      sector = std::strtol(argv[++i], nullptr, 10);
+      if (sector < 1 || sector > 256) return usage();
+    } else if (arg[0] != '-' && !path) {
+      path = arg;
+    } else {
+      return usage();
+    }
+  }
+  if (!path) return usage();
+
+  const int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    std::fprintf(stderr, "vx8_logdump: cannot open %s\n", path);
+    return 1;
+  }
+  // Whole erase blocks only; a short tail cannot hold a page of the log.
+  const uint32_t blocks =
+      static_cast<uint32_t>(st.st_size / vx8::FixLog::kPageSize / sector);
+  static vx8::FixLog log;
+  if (!log.begin(vx8::fileLog(fd, blocks * uint32_t(sector),
+                              static_cast<uint16_t>(sector)))) {
+    std::fprintf(stderr, "vx8_logdump: %s is too small or unreadable\n",
+                 path);
+    return 1;
+  }
+  // Nothing but blank or damaged pages: the next page to write is still
+  // the first.
+  if (log.sequence() == 0) {
+    std::fprintf(stderr, "vx8_logdump: no log in %s\n", path);
+    return 1;
+  }
+
+  vx8::LogExport out;
+  out.begin(format);
+  char line[vx8::LogExport::kMaxLine];
+  while (out.active()) {
+    const uint8_t n = out.next(log, line);
+    if (n == 0) continue;
+    // CR LF as sent on the wire; drop the CR for a text file.
+    std::fwrite(line, 1, n - 2, stdout);
+    std::fputc('\n', stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+// Replays raw GPS captures through the full bridge pipeline and reports
+// throughput, latency, buffer pressure and the device's diagnostic counters;
+// optionally checks the radio-side output byte for byte against a previous
+// run.
+//
+//   vx8_replay [options] capture.nmea [more.nmea ...]
+//     --baud-in N        GPS baud rate (9600)
+//     --baud-out N       radio baud rate (9600)
+//     --loop-us N        main loop poll period in microseconds (500)
+//     --stall-every-us N insert a main-loop stall this often (off)
+//     --stall-us N       length of each stall in microseconds
+//     --raw              no output profile
+//     --no-motion        no motion filter
+//     --bench N          wall-clock benchmark passes (10; 0 to skip)
+//     --out FILE         write the radio-side byte stream to FILE
+//     --expect FILE      compare the radio-side byte stream with FILE
+//
+// Captures are replayed back to back as one stream. Exit status: 0 ok,
+// 1 I/O error, 2 usage, 3 bytes or sentences lost, 4 output differs.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "replay.h"
+
+namespace {
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: vx8_replay [--baud-in N] [--baud-out N] [--loop-us N]\n"
+               "                  [--stall-every-us N --stall-us N]\n"
+               "                  [--raw] [--no-motion] [--bench N]\n"
+               "                  [--out FILE] [--expect FILE]\n"
+               "                  capture.nmea [more.nmea ...]\n");
+  return 2;
+}
+
+bool readFile(const char* path, std::string& out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    std::fprintf(stderr, "vx8_replay: cannot open %s\n", path);
+    return false;
+  }
+  out.append((std::istreambuf_iterator<char>(in)),
+             std::istreambuf_iterator<char>());
+  return true;
+}
+
+uint32_t number(const char* s) {
+  return static_cast<uint32_t>(std::strtoul(s, nullptr, 10));
+}
+
+double ms(uint64_t ns) { return double(ns) / 1e6; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  vx8::sim::ReplayConfig config;
+  config.benchmarkPasses = 10;
+  std::vector<const char*> inputs;
+  const char* output = nullptr;
+  const char* expect = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--baud-in") == 0 && hasValue) {
+      config.line.rxBaud = number(argv[++i]);
+    } else if (std::strcmp(arg, "--baud-out") == 0 && hasValue) {
+      config.line.txBaud = number(argv[++i]);
+    } else if (std::strcmp(arg, "--loop-us") == 0 && hasValue) {
+      config.line.loopPeriodUs = number(argv[++i]);
+    } else if (std::strcmp(arg, "--stall-every-us") == 0 && hasValue) {
+      config.line.stallEveryUs = number(argv[++i]);
+    } else if (std::strcmp(arg, "--stall-us") == 0 && hasValue) {
+      config.line.stallUs = number(argv[++i]);
+    } else if (std::strcmp(arg, "--bench") == 0 && hasValue) {
+      config.benchmarkPasses = number(argv[++i]);
+    } else if (std::strcmp(arg, "--out") == 0 && hasValue) {
+      output = argv[++i];
+    } else if (std::strcmp(arg, "--expect") == 0 && hasValue) {
+      expect = argv[++i];
+    } else if (std::strcmp(arg, "--raw") == 0) {
+      config.profile = false;
+    } else if (std::strcmp(arg, "--no-motion") == 0) {
+      config.motion = false;
+    } else if (arg[0] != '-') {
+      inputs.push_back(arg);
+    } else {
+      return usage();
+    }
+  }
+  if (inputs.empty() || config.line.rxBaud == 0 || config.line.txBaud == 0) {
+    return usage();
+  }
+
+  std::string capture;
+  for (const char* path : inputs) {
+    if (!readFile(path, capture)) return 1;
+  }
+  std::string expected;
+  if (expect && !readFile(expect, expected)) return 1;
+
+  const vx8::sim::ReplayReport r = vx8::sim::runReplay(
+      reinterpret_cast<const uint8_t*>(capture.data()), capture.size(),
+      config);
+
+  if (output) {
+    std::ofstream out(output, std::ios::binary);
+    out.write(r.sim.radioOutput.data(),
+              static_cast<std::streamsize>(r.sim.radioOutput.size()));
+  }
+
+  const vx8::BridgeStats& s = r.sim.stats;
+  std::printf("simulated time      %.3f s\n", double(r.sim.durationNs) / 1e9);
+  std::printf("bytes in/out        %lu / %lu\n", (unsigned long)s.bytesIn,
+              (unsigned long)s.bytesOut);
+  std::printf("sentences           %lu\n", (unsigned long)r.sentences);
+  std::printf("sentences forwarded %u\n", unsigned(s.sentencesForwarded));
+  std::printf("sentences filtered  %u\n", unsigned(s.sentencesFiltered));
+  std::printf("parse errors        %u (checksum %u)\n", unsigned(s.parseErrors),
+              unsigned(s.checksumErrors));
+  std::printf("rx overruns         %u\n", unsigned(s.rxOverruns));
+  std::printf("tx queue full       %u\n", unsigned(s.txQueueFull));
+  std::printf("rx high-water       %u / %u\n", unsigned(s.rxHighWater),
+              unsigned(vx8::Bridge::RxRing::capacity()));
+  std::printf("tx high-water       %u / %u\n", unsigned(s.txHighWater),
+              unsigned(vx8::Bridge::TxQueue::capacity()));
+  std::printf("max byte latency    %.3f ms\n", ms(r.sim.maxByteLatencyNs));
+  std::printf("max parse latency   %.3f ms\n", ms(r.sim.maxParseLatencyNs));
+  std::printf("max queue latency   %.3f ms\n", ms(r.sim.maxQueueLatencyNs));
+  std::printf("max loop pass       %lu us\n",
+              (unsigned long)r.counters.maxLoopUs);
+  if (r.counters.fixAgeS == vx8::Counters::kNoFix) {
+    std::printf("last valid fix      never\n");
+  } else {
+    std::printf("last valid fix      %u s before the end\n",
+                unsigned(r.counters.fixAgeS));
+  }
+  if (r.benchmarkPasses) {
+    std::printf("host throughput     %.0f sentences/s, %.2f MB/s\n",
+                r.sentencesPerSecond(), r.bytesPerSecond() / 1e6);
+  }
+
+  int status = s.rxOverruns == 0 && s.txQueueFull == 0 ? 0 : 3;
+  if (expect) {
+    const vx8::sim::OutputDiff d =
+        vx8::sim::diffOutput(expected, r.sim.radioOutput);
+    if (d.identical) {
+      std::printf("output              matches %s\n", expect);
+    } else {
+      std::printf("output              differs at byte %lu (line %lu)\n",
+                  (unsigned long)d.offset, (unsigned long)d.sentence + 1);
+      std::printf("  expected  %s\n", d.expected.c_str());
+      std::printf("  actual    %s\n", d.actual.c_str());
+      status = 4;
+    }
+  }
+  return status;
+}